@@ -0,0 +1,187 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "building.h"
+#include "building_components.h"
+#include "ecs.h"
+
+// Regle telle que lue dans data/adjacency.json : chaque `near` a moins de
+// `radius` pixels d'un `building` lui ajoute `bonus` d'efficacite, jusqu'a `max`.
+struct AdjacencyRule {
+    std::string id;
+    std::string building;
+    std::string near;
+    double radius = 100.0;
+    double bonus = 0.0;
+    double max = 0.0;
+};
+
+// Regle resolue en index de batiments.
+struct AdjacencyTerm {
+    int target;
+    int source;
+    double radius2;
+    double bonus;
+    double max;
+    int slot;  // index dans Adjacency::near
+
+    double bonusFor(int near) const {
+        const double b = bonus * near;
+        return max > 0.0 ? std::min(b, max) : b;
+    }
+};
+
+// Grille uniforme sur les instances placees. Chaque cible garde, par regle,
+// le nombre de sources dans son rayon : poser ou retirer une source ne fait
+// qu'ajuster de +-1 les cibles de son voisinage, et le tick se contente de
+// lire la colonne Adjacency.
+class AdjacencyIndex {
+public:
+    std::vector<AdjacencyRule> rules;
+
+    void addRule(const AdjacencyRule& r) { rules.push_back(r); }
+
+    void compile(const std::vector<Building>& buildings) {
+        compiled.clear();
+        cellSize = 64.0;
+        for (const auto& r : rules) {
+            AdjacencyTerm c{ indexOf(buildings, r.building), indexOf(buildings, r.near), r.radius * r.radius, r.bonus, r.max, 0 };
+            if (c.target < 0 || c.source < 0 || r.radius <= 0.0) continue;
+            for (const auto& o : compiled) c.slot += o.target == c.target ? 1 : 0;
+            if (c.slot >= Adjacency::kMaxRules) {
+                std::printf("Avertissement: regle de voisinage %s ignoree (plus de %d regles pour %s)\n",
+                            r.id.c_str(), Adjacency::kMaxRules, r.building.c_str());
+                continue;
+            }
+            cellSize = std::max(cellSize, r.radius);
+            compiled.push_back(c);
+        }
+        cells.clear();
+    }
+
+    const std::vector<AdjacencyTerm>& terms() const { return compiled; }
+
+    bool isTarget(int type) const {
+        for (const auto& c : compiled) {
+            if (c.target == type) return true;
+        }
+        return false;
+    }
+
+    void place(World& w, Entity e) {
+        const BuildingInstance* inst = static_cast<const World&>(w).get<BuildingInstance>(e);
+        if (!inst) return;
+        const BuildingInstance copy = *inst;
+        if (isTarget(copy.type)) w.add(e, countAround(w, e, copy));
+        index(e, copy);
+        shiftTargets(w, e, copy, +1);
+    }
+
+    void remove(World& w, Entity e) {
+        const BuildingInstance* inst = static_cast<const World&>(w).get<BuildingInstance>(e);
+        if (!inst) return;
+        const BuildingInstance copy = *inst;
+        unindex(e, copy);
+        shiftTargets(w, e, copy, -1);
+    }
+
+    // Grille seule, compteurs inchanges : pour une restauration d'etat qui
+    // remet aussi les composants Adjacency.
+    void index(Entity e, const BuildingInstance& inst) { cells[keyFor(inst.x, inst.y)].push_back(e); }
+
+    void unindex(Entity e, const BuildingInstance& inst) {
+        auto it = cells.find(keyFor(inst.x, inst.y));
+        if (it == cells.end()) return;
+        auto& v = it->second;
+        v.erase(std::remove(v.begin(), v.end(), e), v.end());
+        if (v.empty()) cells.erase(it);
+    }
+
+private:
+    std::vector<AdjacencyTerm> compiled;
+    double cellSize = 64.0;
+    std::unordered_map<uint64_t, std::vector<Entity>> cells;
+
+    static int indexOf(const std::vector<Building>& buildings, const std::string& id) {
+        for (size_t i = 0; i < buildings.size(); ++i) {
+            if (buildings[i].id == id) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    int cellOf(int v) const { return static_cast<int>(std::floor(v / cellSize)); }
+
+    // Decalage en non signe : cx vaut -1 pres de x = 0.
+    static uint64_t key(int cx, int cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    uint64_t keyFor(int x, int y) const { return key(cellOf(x), cellOf(y)); }
+
+    // f(Entity) pour chaque instance des 3x3 cellules autour de (x, y).
+    template <class F>
+    void forNeighbourCells(int x, int y, F&& f) const {
+        const int cx = cellOf(x), cy = cellOf(y);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto it = cells.find(key(cx + dx, cy + dy));
+                if (it == cells.end()) continue;
+                for (Entity e : it->second) f(e);
+            }
+        }
+    }
+
+    static double dist2(const BuildingInstance& a, const BuildingInstance& b) {
+        const double dx = a.x - b.x, dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+
+    float bonusOf(const Adjacency& a, int type) const {
+        double total = 0.0;
+        for (const auto& c : compiled) {
+            if (c.target == type) total += c.bonusFor(a.near[c.slot]);
+        }
+        return static_cast<float>(total);
+    }
+
+    // Compteurs d'une cible a partir de son voisinage; une seule passe sur les 3x3 cellules.
+    Adjacency countAround(const World& w, Entity self, const BuildingInstance& inst) const {
+        Adjacency a;
+        forNeighbourCells(inst.x, inst.y, [&](Entity o) {
+            const BuildingInstance* other = o != self ? w.get<BuildingInstance>(o) : nullptr;
+            if (!other) return;
+            for (const auto& c : compiled) {
+                if (c.target == inst.type && c.source == other->type && dist2(inst, *other) <= c.radius2) ++a.near[c.slot];
+            }
+        });
+        a.bonus = bonusOf(a, inst.type);
+        return a;
+    }
+
+    // Ajoute `delta` aux compteurs des cibles dans le rayon de la source `changed`.
+    void shiftTargets(World& w, Entity self, const BuildingInstance& changed, int delta) {
+        bool isSource = false;
+        for (const auto& c : compiled) isSource |= c.source == changed.type;
+        if (!isSource) return;
+        forNeighbourCells(changed.x, changed.y, [&](Entity o) {
+            if (o == self) return;
+            const World& cw = w;
+            const BuildingInstance* inst = cw.get<BuildingInstance>(o);
+            if (!inst || !cw.get<Adjacency>(o)) return;
+            const BuildingInstance other = *inst;
+            // get() non const marque la ligne : seulement pour les cibles reellement modifiees.
+            Adjacency* a = nullptr;
+            for (const auto& c : compiled) {
+                if (c.source != changed.type || c.target != other.type || dist2(changed, other) > c.radius2) continue;
+                if (!a) a = w.get<Adjacency>(o);
+                a->near[c.slot] += delta;
+            }
+            if (a) a->bonus = bonusOf(*a, other.type);
+        });
+    }
+};
@@ -9,11 +9,20 @@ Building::Building(std::string i, std::string n,
       name(std::move(n)),
       base_cost(std::move(cost)),
       outputs(std::move(out)),
-      inputs(std::move(in)) {}
+      inputs(std::move(in)) {
+    resetFactors();
+}
+
+void Building::resetFactors() {
+    costFactor.assign(base_cost.size(), 1.0);
+    inputFactor.assign(inputs.size(), 1.0);
+    outputFactor.assign(outputs.size(), 1.0);
+}
 
 std::vector<Cost> Building::nextCost() const {
     std::vector<Cost> c = base_cost;
-    for (auto& x : c) x.qty *= std::pow(growth, count);
+    const double scale = std::pow(growth, count);
+    for (size_t k = 0; k < c.size(); ++k) c[k].qty *= scale * costFactor[k];
     return c;
 }
 
@@ -43,25 +52,25 @@ void Building::build(std::unordered_map<std::string, Resource>& R) {
     }
 }
 
-void Building::produce(std::unordered_map<std::string, Resource>& R, double dt) {
-    if (count <= 0) return;
-    const double multiplier = dt * static_cast<double>(count);
+void Building::produce(std::unordered_map<std::string, Resource>& R, double dt, double units) {
+    if (units <= 0.0) return;
+    const double multiplier = dt * units;
 
-    for (const auto& c : inputs) {
-        auto it = R.find(c.res);
-        if (it == R.end() || it->second.qty < c.qty * multiplier) return;
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        auto it = R.find(inputs[k].res);
+        if (it == R.end() || it->second.qty < inputRate(k) * multiplier) return;
     }
 
-    for (const auto& c : inputs) {
-        auto it = R.find(c.res);
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        auto it = R.find(inputs[k].res);
         if (it != R.end()) {
-            it->second.qty -= c.qty * multiplier;
+            it->second.qty -= inputRate(k) * multiplier;
         }
     }
 
-    for (const auto& c : outputs) {
-        auto& res = R[c.res];
-        if (res.id.empty()) res.id = c.res;
-        res.qty += c.qty * multiplier;
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        auto& res = R[outputs[k].res];
+        if (res.id.empty()) res.id = outputs[k].res;
+        res.qty += outputRate(k) * multiplier;
     }
 }
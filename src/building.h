@@ -21,14 +21,23 @@ public:
     std::vector<Cost> inputs;
     std::vector<Cost> outputs;
 
+    // Coefficients agreges par ModifierSet, un par entree de base_cost/inputs/outputs.
+    std::vector<double> costFactor;
+    std::vector<double> inputFactor;
+    std::vector<double> outputFactor;
+
     Building(std::string i, std::string n,
              std::vector<Cost> cost,
              std::vector<Cost> out,
              std::vector<Cost> in = {});
 
+    void resetFactors();
+    double inputRate(size_t k) const { return inputs[k].qty * inputFactor[k]; }
+    double outputRate(size_t k) const { return outputs[k].qty * outputFactor[k]; }
+
     std::vector<Cost> nextCost() const;
     bool canAfford(const std::unordered_map<std::string,Resource>& R) const;
     void pay(std::unordered_map<std::string,Resource>& R);
     void build(std::unordered_map<std::string,Resource>& R);
-    void produce(std::unordered_map<std::string,Resource>& R,double dt);
+    void produce(std::unordered_map<std::string,Resource>& R, double dt, double units);
 };
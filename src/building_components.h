@@ -0,0 +1,29 @@
+#pragma once
+
+// Composants des instances de batiments stockees dans BuildingManager::instances.
+
+struct BuildingInstance {
+    int type;
+    int x, y;
+};
+
+struct Efficiency {
+    float value = 1.0f;
+};
+
+struct Level {
+    int value = 1;
+};
+
+// 0 = intact, 1 = hors service.
+struct Damage {
+    float value = 0.0f;
+};
+
+// Bonus de voisinage en cache, tenu a jour par AdjacencyIndex. `near[k]`
+// compte les voisins sources de la k-ieme regle visant ce type.
+struct Adjacency {
+    static constexpr int kMaxRules = 4;
+    int near[kMaxRules] = {};
+    float bonus = 0.0f;
+};
@@ -1,32 +1,83 @@
 #pragma once
 #include <vector>
 #include <SDL2/SDL.h>
+#include "adjacency.h"
 #include "building.h"
+#include "building_components.h"
+#include "ecs.h"
 #include "resource_manager.h"
 
-struct BuildingInstance {
-    int type;
-    int x, y;
-};
 
 class BuildingManager {
 public:
     std::vector<Building> prototypes;
-    std::vector<BuildingInstance> placed;
+    World instances;
+    AdjacencyIndex adjacency;
+    // Somme des contributions des instances par prototype, mise a jour a chaque tick.
+    std::vector<double> units;
 
     void addPrototype(const Building& b) { prototypes.push_back(b); }
 
-    void tryBuild(int index, ResourceManager& rm, int x, int y) {
-        if (index < 0 || index >= (int)prototypes.size()) return;
+    double unitsOf(int index) const {
+        if (index >= 0 && index < (int)units.size()) return units[index];
+        return static_cast<double>(prototypes[index].count);
+    }
+
+    // Faux si le prototype n'est pas abordable; `built` recoit l'instance creee.
+    bool tryBuild(int index, ResourceManager& rm, int x, int y, Entity* built = nullptr) {
+        if (index < 0 || index >= (int)prototypes.size()) return false;
         Building& proto = prototypes[index];
-        if (proto.canAfford(rm.resources)) {
-            proto.build(rm.resources);
-            placed.push_back({ index, x, y });
-        }
+        if (!proto.canAfford(rm.resources)) return false;
+        proto.build(rm.resources);
+        Entity e = instances.create(BuildingInstance{ index, x, y }, Efficiency{});
+        adjacency.place(instances, e);
+        if (built) *built = e;
+        return true;
+    }
+
+    // Annule un achat : retire l'instance et rend ce qui avait ete paye.
+    bool refund(Entity e, const std::vector<Cost>& paid, ResourceManager& rm) {
+        if (!instances.alive(e)) return false;
+        demolish(e);
+        // Sans plafond qmax : la production peut le depasser, rendre le cout ne doit rien retirer.
+        for (const auto& c : paid) rm.get(c.res).qty += c.qty;
+        return true;
+    }
+
+    // Retire une instance sans remboursement.
+    void demolish(Entity e) {
+        const BuildingInstance* inst = static_cast<const World&>(instances).get<BuildingInstance>(e);
+        if (!inst) return;
+        Building& proto = prototypes[inst->type];
+        if (proto.count > 0) --proto.count;
+        adjacency.remove(instances, e);
+        instances.destroy(e);
+    }
+
+    // contribution = efficacite * niveau * (1 - degats) * (1 + voisinage), par archetype.
+    void sumUnits() {
+        units.assign(prototypes.size(), 0.0);
+        const World& w = instances;
+        w.eachArchetype<BuildingInstance, Efficiency>([&](const Archetype& a) {
+            const BuildingInstance* inst = a.column<BuildingInstance>();
+            const Efficiency* eff = a.column<Efficiency>();
+            const Level* level = a.column<Level>();
+            const Damage* damage = a.column<Damage>();
+            const Adjacency* adj = a.column<Adjacency>();
+            const size_t n = a.size();
+            for (size_t i = 0; i < n; ++i) {
+                double c = eff[i].value;
+                if (level) c *= level[i].value;
+                if (damage) c *= 1.0 - damage[i].value;
+                if (adj) c *= 1.0 + adj[i].bonus;
+                units[inst[i].type] += c;
+            }
+        });
     }
 
     void produceAll(ResourceManager& rm, double dt) {
-        for (auto& proto : prototypes) proto.produce(rm.resources, dt);
+        sumUnits();
+        for (size_t i = 0; i < prototypes.size(); ++i) prototypes[i].produce(rm.resources, dt, units[i]);
     }
 
     void render(SDL_Renderer* ren) {
@@ -42,13 +93,14 @@ public:
         };
         const int paletteSize = static_cast<int>(sizeof(palette) / sizeof(palette[0]));
 
-        for (auto& inst : placed) {
+        const World& w = instances;
+        w.each<BuildingInstance>([&](Entity, const BuildingInstance& inst) {
             SDL_Rect rect{ inst.x, inst.y, 64, 64 };
             SDL_Color color = palette[paletteSize > 0 ? inst.type % paletteSize : 0];
             SDL_SetRenderDrawColor(ren, color.r, color.g, color.b, color.a);
             SDL_RenderFillRect(ren, &rect);
             SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
             SDL_RenderDrawRect(ren, &rect);
-        }
+        });
     }
 };
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <vector>
+
+enum class CmpOp { Ge, Gt, Le, Lt };
+
+// Predicat sur une variable numerotee (ressource ou effectif de batiment).
+struct ConditionAtom {
+    int var;
+    CmpOp op;
+    double value;
+
+    bool test(double v) const {
+        switch (op) {
+            case CmpOp::Ge: return v >= value;
+            case CmpOp::Gt: return v > value;
+            case CmpOp::Le: return v <= value;
+            case CmpOp::Lt: return v < value;
+        }
+        return false;
+    }
+};
+
+struct ConditionEvent {
+    int condition;
+    bool satisfied;
+};
+
+// Reseau de discrimination pour conjonctions de seuils. Chaque variable
+// garde ses seuils tries; quand elle change de `old` a `now`, seuls les
+// predicats dont le seuil est entre les deux peuvent basculer, et seules
+// les conditions qui en dependent voient leur compteur mis a jour.
+// Un evenement n'est emis qu'a la fin de sync(), si l'etat de la condition
+// differe du dernier signale : les etats intermediaires, melange d'anciennes
+// et de nouvelles valeurs, ne sont jamais observes.
+// Cout par tick : une comparaison par variable + O(log n + basculements).
+class ConditionEngine {
+public:
+    int addCondition(const std::string& id, const std::vector<ConditionAtom>& atoms) {
+        const int c = static_cast<int>(conditions.size());
+        conditions.push_back({ id, static_cast<int>(atoms.size()), 0 });
+        for (const auto& a : atoms) {
+            const int atomId = static_cast<int>(this->atoms.size());
+            this->atoms.push_back({ a, c, false });
+            if (a.var >= static_cast<int>(vars.size())) vars.resize(static_cast<size_t>(a.var) + 1);
+            Var& v = vars[a.var];
+            Threshold t{ a.value, atomId };
+            v.thresholds.insert(std::upper_bound(v.thresholds.begin(), v.thresholds.end(), t), t);
+        }
+        primed = false;
+        return c;
+    }
+
+    int conditionCount() const { return static_cast<int>(conditions.size()); }
+    const std::string& conditionId(int c) const { return conditions[c].id; }
+    bool satisfied(int c) const { return conditions[c].trueAtoms == conditions[c].atomCount; }
+
+    // valueOf(var) -> double. Evalue tout au premier appel, puis seulement
+    // les variables dont la valeur a change depuis l'appel precedent.
+    template <class ValueOf>
+    void sync(ValueOf&& valueOf, std::vector<ConditionEvent>& events) {
+        if (!primed) {
+            prime(valueOf, events);
+            return;
+        }
+        for (size_t i = 0; i < vars.size(); ++i) {
+            Var& v = vars[i];
+            if (v.thresholds.empty()) continue;
+            const double now = valueOf(static_cast<int>(i));
+            if (now == v.last) continue;
+            const double lo = std::min(now, v.last);
+            const double hi = std::max(now, v.last);
+            v.last = now;
+            auto first = std::lower_bound(v.thresholds.begin(), v.thresholds.end(), Threshold{ lo, -1 });
+            for (auto it = first; it != v.thresholds.end() && it->value <= hi; ++it) {
+                setAtom(it->atom, atoms[it->atom].atom.test(now));
+            }
+        }
+        for (int c : touched) {
+            Condition& cond = conditions[c];
+            cond.touched = false;
+            const bool is = satisfied(c);
+            if (is != cond.reported) {
+                cond.reported = is;
+                events.push_back({ c, is });
+            }
+        }
+        touched.clear();
+    }
+
+private:
+    struct Threshold {
+        double value;
+        int atom;
+        bool operator<(const Threshold& o) const { return value < o.value; }
+    };
+
+    struct Var {
+        std::vector<Threshold> thresholds;
+        double last = 0.0;
+    };
+
+    struct AtomState {
+        ConditionAtom atom;
+        int condition;
+        bool value;
+    };
+
+    struct Condition {
+        std::string id;
+        int atomCount;
+        int trueAtoms;
+        bool reported = false;
+        bool touched = false;
+    };
+
+    std::vector<Var> vars;
+    std::vector<AtomState> atoms;
+    std::vector<Condition> conditions;
+    std::vector<int> touched;
+    bool primed = false;
+
+    template <class ValueOf>
+    void prime(ValueOf&& valueOf, std::vector<ConditionEvent>& events) {
+        for (auto& c : conditions) c.trueAtoms = 0;
+        for (size_t i = 0; i < vars.size(); ++i) {
+            if (!vars[i].thresholds.empty()) vars[i].last = valueOf(static_cast<int>(i));
+        }
+        for (auto& a : atoms) {
+            a.value = a.atom.test(vars[a.atom.var].last);
+            if (a.value) ++conditions[a.condition].trueAtoms;
+        }
+        for (size_t c = 0; c < conditions.size(); ++c) {
+            conditions[c].reported = satisfied(static_cast<int>(c));
+            if (conditions[c].reported) events.push_back({ static_cast<int>(c), true });
+        }
+        primed = true;
+    }
+
+    void setAtom(int atomId, bool value) {
+        AtomState& a = atoms[atomId];
+        if (a.value == value) return;
+        Condition& c = conditions[a.condition];
+        a.value = value;
+        c.trueAtoms += value ? 1 : -1;
+        if (!c.touched) {
+            c.touched = true;
+            touched.push_back(a.condition);
+        }
+    }
+};
@@ -0,0 +1,209 @@
+#include "data_loader.h"
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+static bool read_json_file(const std::string& path, json& out) {
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        std::printf("Erreur: impossible d'ouvrir %s\n", path.c_str());
+        return false;
+    }
+    try {
+        f >> out;
+    } catch (const std::exception& ex) {
+        std::printf("Erreur: lecture JSON %s (%s)\n", path.c_str(), ex.what());
+        return false;
+    }
+    return true;
+}
+
+void loadResources(ResourceManager& rm, const std::string& path) {
+    json jr;
+    if (!read_json_file(path, jr)) return;
+    for (auto& r : jr) {
+        const std::string id = r.value("id", "");
+        if (id.empty()) continue;
+        Resource& res = rm.ensureResource(id);
+        res.id = id;
+        res.qty = r.value("qty", 0.0);
+        res.qmin = r.value("qmin", 0.0);
+        res.qmax = r.value("qmax", 0.0);
+    }
+}
+
+void loadBuildings(std::vector<Building>& out, const std::string& path) {
+    json jb;
+    if (!read_json_file(path, jb)) return;
+    for (auto& b : jb) {
+        const std::string id = b.value("id", "");
+        const std::string name = b.value("name", id);
+        std::vector<Cost> cost, inputs, outputs;
+        if (b.contains("cost")) {
+            for (auto& c : b["cost"]) {
+                cost.push_back({ c.value("res", std::string{}), c.value("qty", 0.0) });
+            }
+        }
+        if (b.contains("inputs")) {
+            for (auto& i : b["inputs"]) {
+                inputs.push_back({ i.value("res", std::string{}), i.value("qty", 0.0) });
+            }
+        }
+        if (b.contains("outputs")) {
+            for (auto& o : b["outputs"]) {
+                outputs.push_back({ o.value("res", std::string{}), o.value("qty", 0.0) });
+            }
+        }
+        if (!id.empty()) {
+            out.push_back(Building(id, name, cost, outputs, inputs));
+        }
+    }
+}
+
+static std::vector<Cost> read_costs(const json& j, const char* key) {
+    std::vector<Cost> out;
+    if (j.contains(key)) {
+        for (auto& c : j[key]) {
+            out.push_back({ c.value("res", std::string{}), c.value("qty", 0.0) });
+        }
+    }
+    return out;
+}
+
+void loadRules(RuleSet& rules, const std::string& path) {
+    json jr;
+    if (!read_json_file(path, jr)) return;
+    for (auto& r : jr) {
+        Rule rule;
+        rule.id = r.value("id", "");
+        rule.per = r.value("per", "");
+        rule.perBuilding = r.value("per_building", "");
+        rule.inputs = read_costs(r, "inputs");
+        rule.outputs = read_costs(r, "outputs");
+        rule.cap = r.value("cap", "");
+        rule.base = r.value("base", 0.0);
+        rule.qty = r.value("qty", 0.0);
+        rules.addRule(rule);
+    }
+}
+
+static ModTarget parse_mod_target(const std::string& s) {
+    if (s == "input") return ModTarget::Input;
+    if (s == "cost") return ModTarget::Cost;
+    return ModTarget::Output;
+}
+
+void loadUpgrades(UpgradeManager& um, const std::string& path) {
+    json ju;
+    if (!read_json_file(path, ju)) return;
+    for (auto& u : ju) {
+        Upgrade up;
+        up.id = u.value("id", "");
+        if (up.id.empty()) continue;
+        up.name = u.value("name", up.id);
+        up.cost = read_costs(u, "cost");
+        if (u.contains("modifiers")) {
+            for (auto& m : u["modifiers"]) {
+                Modifier mod;
+                mod.building = m.value("building", "");
+                mod.res = m.value("res", "");
+                mod.target = parse_mod_target(m.value("target", "output"));
+                mod.add = m.value("add", 0.0);
+                mod.mul = m.value("mul", 1.0);
+                up.modifiers.push_back(mod);
+            }
+        }
+        um.addUpgrade(up);
+    }
+}
+
+static CmpOp parse_cmp_op(const std::string& s) {
+    if (s == ">") return CmpOp::Gt;
+    if (s == "<=") return CmpOp::Le;
+    if (s == "<") return CmpOp::Lt;
+    return CmpOp::Ge;
+}
+
+void loadQuests(QuestManager& qm, const std::string& path) {
+    json jq;
+    if (!read_json_file(path, jq)) return;
+    for (auto& q : jq) {
+        Quest quest;
+        quest.id = q.value("id", "");
+        if (quest.id.empty()) continue;
+        quest.name = q.value("name", quest.id);
+        if (q.contains("all")) {
+            for (auto& c : q["all"]) {
+                QuestCondition cond;
+                cond.res = c.value("res", "");
+                cond.building = c.value("building", "");
+                cond.op = parse_cmp_op(c.value("op", ">="));
+                cond.value = c.value("value", 0.0);
+                quest.all.push_back(cond);
+            }
+        }
+        qm.addQuest(quest);
+    }
+}
+
+void loadAdjacency(AdjacencyIndex& adj, const std::string& path) {
+    json ja;
+    if (!read_json_file(path, ja)) return;
+    for (auto& a : ja) {
+        AdjacencyRule rule;
+        rule.id = a.value("id", "");
+        rule.building = a.value("building", "");
+        rule.near = a.value("near", "");
+        rule.radius = a.value("radius", 100.0);
+        rule.bonus = a.value("bonus", 0.0);
+        rule.max = a.value("max", 0.0);
+        if (!rule.building.empty() && !rule.near.empty()) adj.addRule(rule);
+    }
+}
+
+void loadGameData(const std::filesystem::path& dataDir, ResourceManager& rm, std::vector<Building>& buildings,
+                  RuleSet& rules, UpgradeManager& um) {
+    loadResources(rm, (dataDir / "resources.json").string());
+    loadBuildings(buildings, (dataDir / "buildings.json").string());
+    loadRules(rules, (dataDir / "rules.json").string());
+    loadUpgrades(um, (dataDir / "upgrades.json").string());
+
+    for (const auto& proto : buildings) {
+        for (const auto& c : proto.base_cost) {
+            if (!c.res.empty()) {
+                Resource& res = rm.ensureResource(c.res);
+                if (res.id.empty()) res.id = c.res;
+            }
+        }
+        for (const auto& c : proto.inputs) {
+            if (!c.res.empty()) {
+                Resource& res = rm.ensureResource(c.res);
+                if (res.id.empty()) res.id = c.res;
+            }
+        }
+        for (const auto& c : proto.outputs) {
+            if (!c.res.empty()) {
+                Resource& res = rm.ensureResource(c.res);
+                if (res.id.empty()) res.id = c.res;
+            }
+        }
+    }
+
+    for (const auto& u : um.upgrades) {
+        for (const auto& c : u.cost) {
+            if (!c.res.empty()) rm.ensureResource(c.res);
+        }
+    }
+
+    rules.compile(rm, buildings);
+    um.checkModifiers(buildings);
+
+    if (rm.resources.empty()) {
+        std::printf("Avertissement: aucune ressource chargee depuis %s\n", (dataDir / "resources.json").string().c_str());
+    }
+    if (buildings.empty()) {
+        std::printf("Avertissement: aucun batiment charge depuis %s\n", (dataDir / "buildings.json").string().c_str());
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "adjacency.h"
+#include "building.h"
+#include "quest_manager.h"
+#include "resource_manager.h"
+#include "rules.h"
+#include "upgrade_manager.h"
+
+void loadResources(ResourceManager& rm, const std::string& path);
+void loadBuildings(std::vector<Building>& out, const std::string& path);
+void loadRules(RuleSet& rules, const std::string& path);
+void loadUpgrades(UpgradeManager& um, const std::string& path);
+void loadQuests(QuestManager& qm, const std::string& path);
+void loadAdjacency(AdjacencyIndex& adj, const std::string& path);
+
+// Charge tous les fichiers de dataDir, enregistre les ressources referencees
+// et compile les regles.
+void loadGameData(const std::filesystem::path& dataDir, ResourceManager& rm, std::vector<Building>& buildings,
+                  RuleSet& rules, UpgradeManager& um);
@@ -0,0 +1,389 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Stockage entite-composant par archetypes : toutes les entites ayant le
+// meme ensemble de composants partagent un Archetype, ou chaque type de
+// composant est une colonne contigue. Les requetes ne parcourent que les
+// archetypes dont le masque contient les composants demandes.
+
+using ComponentMask = uint64_t;
+
+inline int nextComponentId() {
+    static int next = 0;
+    return next++;
+}
+
+template <class C>
+int componentId() {
+    static const int id = nextComponentId();
+    return id;
+}
+
+template <class C>
+ComponentMask componentBit() {
+    return ComponentMask(1) << componentId<C>();
+}
+
+struct Entity {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+class ColumnBase {
+public:
+    virtual ~ColumnBase() = default;
+    virtual std::unique_ptr<ColumnBase> cloneEmpty() const = 0;
+    virtual void swapRemove(size_t row) = 0;
+    virtual void moveRowTo(size_t row, ColumnBase& dst) = 0;
+    virtual size_t size() const = 0;
+    virtual size_t elementSize() const = 0;
+    virtual void resize(size_t n) = 0;
+    virtual void* raw() = 0;
+};
+
+template <class C>
+class Column : public ColumnBase {
+public:
+    static_assert(std::is_trivially_copyable<C>::value, "les composants doivent etre trivialement copiables");
+
+    std::vector<C> data;
+
+    std::unique_ptr<ColumnBase> cloneEmpty() const override { return std::make_unique<Column<C>>(); }
+
+    void swapRemove(size_t row) override {
+        if (row + 1 != data.size()) data[row] = data.back();
+        data.pop_back();
+    }
+
+    void moveRowTo(size_t row, ColumnBase& dst) override {
+        static_cast<Column<C>&>(dst).data.push_back(data[row]);
+        swapRemove(row);
+    }
+
+    size_t size() const override { return data.size(); }
+    size_t elementSize() const override { return sizeof(C); }
+    void resize(size_t n) override { data.resize(n); }
+    void* raw() override { return data.data(); }
+};
+
+// Lignes ecrites depuis le dernier World::clearDirty(), pour que StateHistory
+// ne reexamine que les blocs touches. Au-dela de kLimit, tout est considere ecrit.
+struct DirtyRows {
+    static constexpr size_t kLimit = 4096;
+    std::vector<size_t> rows;
+    bool all = false;
+
+    void mark(size_t row) {
+        if (all) return;
+        if (rows.size() >= kLimit) {
+            markAll();
+            return;
+        }
+        rows.push_back(row);
+    }
+
+    void markAll() {
+        all = true;
+        rows.clear();
+    }
+
+    void clear() {
+        all = false;
+        rows.clear();
+    }
+};
+
+class Archetype {
+public:
+    ComponentMask mask = 0;
+    std::vector<int> ids;
+    std::vector<std::unique_ptr<ColumnBase>> columns;
+    std::vector<Entity> entities;
+    DirtyRows dirty;
+
+    size_t size() const { return entities.size(); }
+
+    ColumnBase* columnById(int id) {
+        for (size_t k = 0; k < ids.size(); ++k) {
+            if (ids[k] == id) return columns[k].get();
+        }
+        return nullptr;
+    }
+
+    const ColumnBase* columnById(int id) const {
+        for (size_t k = 0; k < ids.size(); ++k) {
+            if (ids[k] == id) return columns[k].get();
+        }
+        return nullptr;
+    }
+
+    // nullptr si l'archetype n'a pas ce composant.
+    template <class C>
+    C* column() {
+        ColumnBase* c = columnById(componentId<C>());
+        return c ? static_cast<Column<C>*>(c)->data.data() : nullptr;
+    }
+
+    template <class C>
+    const C* column() const {
+        const ColumnBase* c = columnById(componentId<C>());
+        return c ? static_cast<const Column<C>*>(c)->data.data() : nullptr;
+    }
+};
+
+// Parcours en lecture seule des archetypes d'un World : une ecriture par
+// Archetype::column() ne marquerait pas ses lignes et serait perdue par StateHistory.
+class ArchetypeView {
+public:
+    using Storage = std::vector<std::unique_ptr<Archetype>>;
+
+    class iterator {
+    public:
+        explicit iterator(Storage::const_iterator it) : it(it) {}
+        const Archetype& operator*() const { return **it; }
+        iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        bool operator!=(const iterator& o) const { return it != o.it; }
+
+    private:
+        Storage::const_iterator it;
+    };
+
+    explicit ArchetypeView(const Storage& archetypes) : archetypes(archetypes) {}
+    iterator begin() const { return iterator(archetypes.begin()); }
+    iterator end() const { return iterator(archetypes.end()); }
+    size_t size() const { return archetypes.size(); }
+
+private:
+    const Storage& archetypes;
+};
+
+// Les acces en ecriture (get, each et eachArchetype non const, mutations)
+// marquent les lignes touchees; lire via un `const World&` ne marque rien.
+class World {
+public:
+    template <class... Cs>
+    Entity create(const Cs&... comps) {
+        static_assert(sizeof...(Cs) > 0, "une entite a au moins un composant");
+        (registerComponent<Cs>(), ...);
+        Archetype& a = archetypeFor((componentBit<Cs>() | ...));
+        (pushComponent(a, comps), ...);
+        return attach(a);
+    }
+
+    void destroy(Entity e) {
+        if (!alive(e)) return;
+        Record& rec = records[e.index];
+        for (auto& c : rec.archetype->columns) c->swapRemove(rec.row);
+        detachRow(*rec.archetype, rec.row);
+        rec.archetype = nullptr;
+        ++rec.generation;
+        recordsDirty.mark(e.index);
+        freeList.push_back(e.index);
+        freeListDirty.mark(freeList.size() - 1);
+        --liveCount;
+    }
+
+    bool alive(Entity e) const {
+        return e.index < records.size() && records[e.index].generation == e.generation && records[e.index].archetype;
+    }
+
+    template <class C>
+    C* get(Entity e) {
+        if (!alive(e)) return nullptr;
+        Record& rec = records[e.index];
+        C* col = rec.archetype->column<C>();
+        if (!col) return nullptr;
+        rec.archetype->dirty.mark(rec.row);
+        return col + rec.row;
+    }
+
+    template <class C>
+    const C* get(Entity e) const {
+        if (!alive(e)) return nullptr;
+        const Record& rec = records[e.index];
+        const C* col = static_cast<const Archetype*>(rec.archetype)->column<C>();
+        return col ? col + rec.row : nullptr;
+    }
+
+    template <class C>
+    void add(Entity e, const C& comp) {
+        if (!alive(e)) return;
+        if (C* existing = get<C>(e)) {
+            *existing = comp;
+            return;
+        }
+        registerComponent<C>();
+        Record& rec = records[e.index];
+        Archetype& dst = archetypeFor(rec.archetype->mask | componentBit<C>());
+        migrate(e, dst);
+        pushComponent(dst, comp);
+    }
+
+    template <class C>
+    void remove(Entity e) {
+        if (!alive(e) || !static_cast<const World*>(this)->get<C>(e)) return;
+        Record& rec = records[e.index];
+        const ComponentMask mask = rec.archetype->mask & ~componentBit<C>();
+        if (mask == 0) {
+            destroy(e);
+            return;
+        }
+        migrate(e, archetypeFor(mask));
+    }
+
+    // f(Archetype&) pour chaque archetype contenant tous les Cs.
+    template <class... Cs, class F>
+    void eachArchetype(F&& f) {
+        const ComponentMask want = (componentBit<Cs>() | ... | ComponentMask(0));
+        for (auto& a : archetypes) {
+            if ((a->mask & want) != want || a->size() == 0) continue;
+            a->dirty.markAll();
+            f(*a);
+        }
+    }
+
+    template <class... Cs, class F>
+    void eachArchetype(F&& f) const {
+        const ComponentMask want = (componentBit<Cs>() | ... | ComponentMask(0));
+        for (const auto& a : archetypes) {
+            if ((a->mask & want) == want && a->size() > 0) f(static_cast<const Archetype&>(*a));
+        }
+    }
+
+    // f(Entity, Cs&...) pour chaque entite ayant tous les Cs.
+    template <class... Cs, class F>
+    void each(F&& f) {
+        eachArchetype<Cs...>([&](Archetype& a) {
+            auto cols = std::make_tuple(a.column<Cs>()...);
+            for (size_t i = 0; i < a.size(); ++i) {
+                f(a.entities[i], std::get<Cs*>(cols)[i]...);
+            }
+        });
+    }
+
+    template <class... Cs, class F>
+    void each(F&& f) const {
+        eachArchetype<Cs...>([&](const Archetype& a) {
+            auto cols = std::make_tuple(a.column<Cs>()...);
+            for (size_t i = 0; i < a.size(); ++i) {
+                f(a.entities[i], std::get<const Cs*>(cols)[i]...);
+            }
+        });
+    }
+
+    size_t size() const { return liveCount; }
+    ArchetypeView allArchetypes() const { return ArchetypeView(archetypes); }
+
+private:
+    friend class StateHistory;
+
+    struct Record {
+        Archetype* archetype = nullptr;
+        size_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::vector<std::unique_ptr<ColumnBase>> prototypes;
+    std::vector<Record> records;
+    std::vector<uint32_t> freeList;
+    size_t liveCount = 0;
+    DirtyRows recordsDirty;
+    DirtyRows freeListDirty;
+
+    void clearDirty() {
+        for (auto& a : archetypes) a->dirty.clear();
+        recordsDirty.clear();
+        freeListDirty.clear();
+    }
+
+    template <class C>
+    void registerComponent() {
+        const int id = componentId<C>();
+        if (id >= 64) std::abort();
+        if (static_cast<int>(prototypes.size()) <= id) prototypes.resize(static_cast<size_t>(id) + 1);
+        if (!prototypes[id]) prototypes[id] = std::make_unique<Column<C>>();
+    }
+
+    // Un archetype n'est jamais detruit ni deplace (unique_ptr, jamais retire
+    // de `archetypes`) : Record::archetype reste valide, et StateHistory peut
+    // copier `records` tels quels, pointeurs compris, puis les restaurer.
+    Archetype& archetypeFor(ComponentMask mask) {
+        for (auto& a : archetypes) {
+            if (a->mask == mask) return *a;
+        }
+        auto a = std::make_unique<Archetype>();
+        a->mask = mask;
+        for (int id = 0; id < 64; ++id) {
+            if (mask & (ComponentMask(1) << id)) {
+                a->ids.push_back(id);
+                a->columns.push_back(prototypes[id]->cloneEmpty());
+            }
+        }
+        archetypes.push_back(std::move(a));
+        return *archetypes.back();
+    }
+
+    template <class C>
+    static void pushComponent(Archetype& a, const C& comp) {
+        static_cast<Column<C>*>(a.columnById(componentId<C>()))->data.push_back(comp);
+    }
+
+    Entity attach(Archetype& a) {
+        uint32_t index;
+        if (!freeList.empty()) {
+            index = freeList.back();
+            freeList.pop_back();
+        } else {
+            index = static_cast<uint32_t>(records.size());
+            records.emplace_back();
+        }
+        Record& rec = records[index];
+        rec.archetype = &a;
+        rec.row = a.entities.size();
+        Entity e{ index, rec.generation };
+        a.entities.push_back(e);
+        a.dirty.mark(rec.row);
+        recordsDirty.mark(index);
+        ++liveCount;
+        return e;
+    }
+
+    void detachRow(Archetype& a, size_t row) {
+        if (row + 1 != a.entities.size()) {
+            a.entities[row] = a.entities.back();
+            records[a.entities[row].index].row = row;
+            recordsDirty.mark(a.entities[row].index);
+        }
+        a.entities.pop_back();
+        a.dirty.mark(row);
+    }
+
+    // Deplace les composants communs vers dst; ceux absents de dst sont perdus.
+    void migrate(Entity e, Archetype& dst) {
+        Record& rec = records[e.index];
+        Archetype& src = *rec.archetype;
+        const size_t row = rec.row;
+        for (size_t k = 0; k < src.ids.size(); ++k) {
+            if (ColumnBase* d = dst.columnById(src.ids[k])) src.columns[k]->moveRowTo(row, *d);
+            else src.columns[k]->swapRemove(row);
+        }
+        detachRow(src, row);
+        rec.archetype = &dst;
+        rec.row = dst.entities.size();
+        dst.entities.push_back(e);
+        dst.dirty.mark(rec.row);
+        recordsDirty.mark(e.index);
+    }
+};
@@ -6,17 +6,18 @@
 #include <cctype>
 #include <cmath>
 #include <cstdio>
-#include <fstream>
 #include <filesystem>
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
-#include <nlohmann/json.hpp>
 #include "resource_manager.h"
 #include "building_manager.h"
-
-using json = nlohmann::json;
+#include "data_loader.h"
+#include "snapshot.h"
+#include "telemetry.h"
+#include "yard_layout.h"
 
 static void draw_bar(SDL_Renderer* r, int x, int y, int w, int h, double v, double vmin, double vmax) {
     SDL_Rect bg{ x, y, w, h };
@@ -36,6 +37,37 @@ static void draw_bar(SDL_Renderer* r, int x, int y, int w, int h, double v, doub
     SDL_RenderDrawRect(r, &bg);
 }
 
+static void draw_sparkline(SDL_Renderer* r, const SDL_Rect& area, const std::vector<TelemetryBucket>& history, size_t capacity) {
+    SDL_SetRenderDrawColor(r, 26, 26, 36, 255);
+    SDL_RenderFillRect(r, &area);
+    if (history.empty() || area.w <= 2 || area.h <= 2) return;
+    float lo = history.front().qmin;
+    float hi = history.front().qmax;
+    for (const auto& b : history) {
+        lo = std::min(lo, b.qmin);
+        hi = std::max(hi, b.qmax);
+    }
+    if (hi - lo < 1e-3f) hi = lo + 1.0f;
+    auto yFor = [&](float v) {
+        return area.y + area.h - 1 - static_cast<int>((v - lo) / (hi - lo) * static_cast<float>(area.h - 1));
+    };
+    const size_t slots = std::max(capacity, history.size());
+    const size_t offset = slots - history.size();
+    int prevX = -1, prevY = 0;
+    for (size_t i = 0; i < history.size(); ++i) {
+        const TelemetryBucket& b = history[i];
+        int x = area.x + static_cast<int>((offset + i) * static_cast<size_t>(area.w - 1) / std::max<size_t>(1, slots - 1));
+        SDL_SetRenderDrawColor(r, 70, 90, 80, 255);
+        SDL_RenderDrawLine(r, x, yFor(b.qmin), x, yFor(b.qmax));
+        int y = yFor(b.qmean);
+        SDL_SetRenderDrawColor(r, b.rate < 0.0f ? 220 : 140, b.rate < 0.0f ? 140 : 220, 150, 255);
+        if (prevX >= 0) SDL_RenderDrawLine(r, prevX, prevY, x, y);
+        else SDL_RenderDrawPoint(r, x, y);
+        prevX = x;
+        prevY = y;
+    }
+}
+
 static void draw_panel(SDL_Renderer* r, const SDL_Rect& rect, SDL_Color fill, SDL_Color border) {
     SDL_SetRenderDrawColor(r, fill.r, fill.g, fill.b, fill.a);
     SDL_RenderFillRect(r, &rect);
@@ -252,85 +284,33 @@ static std::string join_costs(const std::vector<Cost>& costs) {
     return os.str();
 }
 
-static std::string join_rates(const std::vector<Cost>& rates, int count, bool isOutput) {
-    if (rates.empty() || count <= 0) return "--";
+static std::string join_rates(const Building& b, double units, bool isOutput) {
+    const std::vector<Cost>& rates = isOutput ? b.outputs : b.inputs;
+    if (rates.empty() || units <= 0.0) return "--";
     std::ostringstream os;
     for (size_t i = 0; i < rates.size(); ++i) {
         if (i > 0) os << ", ";
-        double perSecond = rates[i].qty * static_cast<double>(count);
+        double rate = isOutput ? b.outputRate(i) : b.inputRate(i);
+        double perSecond = rate * units;
         if (!isOutput) perSecond = -perSecond;
         os << rates[i].res << ' ' << format_signed(perSecond) << "/s";
     }
     return os.str();
 }
 
-static bool read_json_file(const std::string& path, json& out) {
-    std::ifstream f(path);
-    if (!f.is_open()) {
-        std::printf("Erreur: impossible d'ouvrir %s\n", path.c_str());
-        return false;
-    }
-    try {
-        f >> out;
-    } catch (const std::exception& ex) {
-        std::printf("Erreur: lecture JSON %s (%s)\n", path.c_str(), ex.what());
-        return false;
-    }
-    return true;
-}
-
-void loadResources(ResourceManager& rm, const std::string& path) {
-    json jr;
-    if (!read_json_file(path, jr)) return;
-    for (auto& r : jr) {
-        const std::string id = r.value("id", "");
-        if (id.empty()) continue;
-        Resource& res = rm.ensureResource(id);
-        res.id = id;
-        res.qty = r.value("qty", 0.0);
-        res.qmin = r.value("qmin", 0.0);
-        res.qmax = r.value("qmax", 0.0);
-    }
-}
-
-void loadBuildings(BuildingManager& bm, const std::string& path) {
-    json jb;
-    if (!read_json_file(path, jb)) return;
-    for (auto& b : jb) {
-        const std::string id = b.value("id", "");
-        const std::string name = b.value("name", id);
-        std::vector<Cost> cost, inputs, outputs;
-        if (b.contains("cost")) {
-            for (auto& c : b["cost"]) {
-                cost.push_back({ c.value("res", std::string{}), c.value("qty", 0.0) });
-            }
-        }
-        if (b.contains("inputs")) {
-            for (auto& i : b["inputs"]) {
-                inputs.push_back({ i.value("res", std::string{}), i.value("qty", 0.0) });
-            }
-        }
-        if (b.contains("outputs")) {
-            for (auto& o : b["outputs"]) {
-                outputs.push_back({ o.value("res", std::string{}), o.value("qty", 0.0) });
-            }
-        }
-        if (!id.empty()) {
-            bm.addPrototype(Building(id, name, cost, outputs, inputs));
-        }
-    }
-}
-
 int main(int argc, char* argv[]) {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) return 1;
     SDL_Window* win = SDL_CreateWindow("Medieval Idle",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, 0);
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, screen::windowWidth, screen::windowHeight, 0);
     if (!win) { SDL_Quit(); return 2; }
     SDL_Renderer* ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!ren) { SDL_DestroyWindow(win); SDL_Quit(); return 3; }
 
     ResourceManager rm;
     BuildingManager bm;
+    RuleSet rules;
+    UpgradeManager um;
+    QuestManager qm;
 
     std::filesystem::path dataDir;
     if (char* base = SDL_GetBasePath()) {
@@ -341,36 +321,11 @@ int main(int argc, char* argv[]) {
     }
     dataDir /= "data";
 
-    loadResources(rm, (dataDir / "resources.json").string());
-    loadBuildings(bm, (dataDir / "buildings.json").string());
-
-    for (const auto& proto : bm.prototypes) {
-        for (const auto& c : proto.base_cost) {
-            if (!c.res.empty()) {
-                Resource& res = rm.ensureResource(c.res);
-                if (res.id.empty()) res.id = c.res;
-            }
-        }
-        for (const auto& c : proto.inputs) {
-            if (!c.res.empty()) {
-                Resource& res = rm.ensureResource(c.res);
-                if (res.id.empty()) res.id = c.res;
-            }
-        }
-        for (const auto& c : proto.outputs) {
-            if (!c.res.empty()) {
-                Resource& res = rm.ensureResource(c.res);
-                if (res.id.empty()) res.id = c.res;
-            }
-        }
-    }
-
-    if (rm.resources.empty()) {
-        std::printf("Avertissement: aucune ressource chargee depuis %s\n", (dataDir / "resources.json").string().c_str());
-    }
-    if (bm.prototypes.empty()) {
-        std::printf("Avertissement: aucun batiment charge depuis %s\n", (dataDir / "buildings.json").string().c_str());
-    }
+    loadGameData(dataDir, rm, bm.prototypes, rules, um);
+    loadQuests(qm, (dataDir / "quests.json").string());
+    qm.compile(rm, bm.prototypes);
+    loadAdjacency(bm.adjacency, (dataDir / "adjacency.json").string());
+    bm.adjacency.compile(bm.prototypes);
 
     const std::array<SDL_Scancode, 36> keyPool = {
         SDL_SCANCODE_1, SDL_SCANCODE_2, SDL_SCANCODE_3, SDL_SCANCODE_4, SDL_SCANCODE_5,
@@ -383,6 +338,11 @@ int main(int argc, char* argv[]) {
         SDL_SCANCODE_N, SDL_SCANCODE_M
     };
 
+    const std::array<SDL_Scancode, 12> upgradeKeyPool = {
+        SDL_SCANCODE_F1, SDL_SCANCODE_F2, SDL_SCANCODE_F3, SDL_SCANCODE_F4, SDL_SCANCODE_F5, SDL_SCANCODE_F6,
+        SDL_SCANCODE_F7, SDL_SCANCODE_F8, SDL_SCANCODE_F9, SDL_SCANCODE_F10, SDL_SCANCODE_F11, SDL_SCANCODE_F12
+    };
+
     std::vector<SDL_Scancode> buildingHotkeys;
     std::vector<std::string> buildingKeyLabels;
     buildingHotkeys.reserve(bm.prototypes.size());
@@ -407,75 +367,151 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    constexpr int windowWidth = 1280;
-    constexpr int windowHeight = 720;
-    const int layoutMargin = 20;
-    const int topMargin = 30;
-    const int bottomPanelHeight = 110;
-    const int resourcePanelWidth = 360;
-    const int buildingPanelWidth = 360;
-    const int mainAreaHeight = windowHeight - bottomPanelHeight - topMargin - layoutMargin;
-
+    using namespace screen;
+    const YardLayout yard(bm.prototypes.size());
     SDL_Rect resourcePanel{ layoutMargin, topMargin, resourcePanelWidth, mainAreaHeight };
     SDL_Rect buildingPanel{ resourcePanel.x + resourcePanel.w + layoutMargin, topMargin, buildingPanelWidth, mainAreaHeight };
-    SDL_Rect yardArea{ buildingPanel.x + buildingPanel.w + layoutMargin, topMargin,
-        std::max(220, windowWidth - (buildingPanel.x + buildingPanel.w + 2 * layoutMargin)), mainAreaHeight };
-
-    const int yardSlotSize = 64;
-    const int yardSlotSpacing = 24;
-    const int yardLabelHeight = 36;
-    int yardRows = std::max(1, (yardArea.h - yardLabelHeight) / (yardSlotSize + yardSlotSpacing));
-    int yardColumns = std::max(1, static_cast<int>((bm.prototypes.size() + yardRows - 1) / std::max(1, yardRows)));
-    int maxYardColumns = std::max(1, (yardArea.w - 60) / (yardSlotSize + yardSlotSpacing));
-    if (yardColumns > maxYardColumns) {
-        yardColumns = maxYardColumns;
-        yardRows = std::max(1, static_cast<int>((bm.prototypes.size() + yardColumns - 1) / std::max(1, yardColumns)));
-    }
-    const int yardInstancePerRow = 2;
-    const int yardInstanceSpacingX = 74;
-    const int yardInstanceSpacingY = 74;
-
-    auto anchorForIndex = [&](int index) {
-        if (yardArea.w <= 0) return SDL_Point{ yardArea.x, yardArea.y + yardLabelHeight };
-        int column = yardColumns > 0 ? index / yardRows : 0;
-        int row = yardRows > 0 ? index % yardRows : 0;
-        column = std::min(column, std::max(0, yardColumns - 1));
-        row = std::min(row, std::max(0, yardRows - 1));
-        int x = yardArea.x + 24 + column * (yardSlotSize + yardSlotSpacing);
-        int y = yardArea.y + yardLabelHeight + row * (yardSlotSize + yardSlotSpacing);
-        return SDL_Point{ x, y };
-    };
+    SDL_Rect yardArea{ yard.x, yard.y, yard.w, yard.h };
 
     const double dt = 0.1;
+    Telemetry telemetry(rm.size(), dt);
+    int historyTier = 1;
+    std::vector<TelemetryBucket> historyScratch;
     double acc = 0.0;
     double title_acc = 0.0;
+    double gameTime = 0.0;
+    const double autoSnapshotPeriod = 10.0;
+    double nextAutoSnapshot = autoSnapshotPeriod;
+    StateHistory history(256);
+    history.capture(rm, bm, um, gameTime, "auto");
+    // Achats annulables par Retour, le plus recent en dernier. Vide apres un rembobinage.
+    struct Purchase {
+        int upgrade = -1;
+        Entity building;
+        std::vector<Cost> paid;
+    };
+    std::vector<Purchase> purchases;
     auto prev = std::chrono::high_resolution_clock::now();
     bool run = true;
 
+    // Economie d'energie : fenetre cachee = aucun rendu, reveil par lots;
+    // fenetre visible = rendu seulement apres une entree ou un changement.
+    const int hiddenWakeMs = 1000;
+    bool hidden = (SDL_GetWindowFlags(win) & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED)) != 0;
+    bool needsRedraw = true;
+    std::vector<double> shownQty;
+    std::vector<int> shownCounts;
+    auto stateChanged = [&]() {
+        bool changed = static_cast<int>(shownQty.size()) != rm.size() || shownCounts.size() != bm.prototypes.size();
+        shownQty.resize(rm.size());
+        shownCounts.resize(bm.prototypes.size());
+        for (int r = 0; r < rm.size(); ++r) {
+            if (shownQty[r] != rm.at(r).qty) {
+                shownQty[r] = rm.at(r).qty;
+                changed = true;
+            }
+        }
+        for (size_t b = 0; b < bm.prototypes.size(); ++b) {
+            if (shownCounts[b] != bm.prototypes[b].count) {
+                shownCounts[b] = bm.prototypes[b].count;
+                changed = true;
+            }
+        }
+        return changed;
+    };
+
     auto triggerBuild = [&](int index) {
         if (index < 0 || index >= static_cast<int>(bm.prototypes.size())) return;
-        SDL_Point anchor = anchorForIndex(index);
-        int built = bm.prototypes[index].count;
-        int instCol = built % yardInstancePerRow;
-        int instRow = built / yardInstancePerRow;
-        int x = anchor.x + instCol * yardInstanceSpacingX;
-        int y = anchor.y + instRow * yardInstanceSpacingY;
-        bm.tryBuild(index, rm, x, y);
+        const YardPoint at = yard.instance(index, bm.prototypes[index].count);
+        if (!bm.prototypes[index].canAfford(rm.resources)) return;
+        // Instantane juste avant l'achat : PgUp peut y revenir, Retour rembourse seulement l'achat.
+        history.capture(rm, bm, um, gameTime, "achat");
+        std::vector<Cost> cost = bm.prototypes[index].nextCost();
+        Entity built;
+        if (bm.tryBuild(index, rm, at.x, at.y, &built)) purchases.push_back(Purchase{ -1, built, std::move(cost) });
     };
 
-    while (run) {
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) run = false;
-            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) run = false;
-            if (e.type == SDL_KEYDOWN) {
-                for (size_t i = 0; i < buildingHotkeys.size(); ++i) {
-                    if (buildingHotkeys[i] != SDL_SCANCODE_UNKNOWN && e.key.keysym.scancode == buildingHotkeys[i]) {
-                        triggerBuild(static_cast<int>(i));
-                        break;
-                    }
+    auto restoreSnapshot = [&](int index) {
+        if (index < 0) return;
+        double t = history.at(static_cast<size_t>(index)).time;
+        if (history.restore(static_cast<size_t>(index), rm, bm, um)) {
+            gameTime = t;
+            purchases.clear();
+            telemetry.clear();
+            nextAutoSnapshot = gameTime + autoSnapshotPeriod;
+        }
+    };
+
+    auto handleEvent = [&](const SDL_Event& e) {
+        if (e.type == SDL_WINDOWEVENT) {
+            switch (e.window.event) {
+                case SDL_WINDOWEVENT_HIDDEN:
+                case SDL_WINDOWEVENT_MINIMIZED:
+                    hidden = true;
+                    break;
+                case SDL_WINDOWEVENT_SHOWN:
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_MAXIMIZED:
+                    hidden = false;
+                    needsRedraw = true;
+                    break;
+                case SDL_WINDOWEVENT_EXPOSED:
+                case SDL_WINDOWEVENT_SIZE_CHANGED:
+                    needsRedraw = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (e.type == SDL_KEYDOWN) needsRedraw = true;
+        if (e.type == SDL_QUIT) run = false;
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) run = false;
+        if (e.type == SDL_KEYDOWN && e.key.keysym.scancode == SDL_SCANCODE_TAB) {
+            historyTier = (historyTier + 1) % telemetry.tierCount();
+        }
+        if (e.type == SDL_KEYDOWN) {
+            for (size_t i = 0; i < buildingHotkeys.size(); ++i) {
+                if (buildingHotkeys[i] != SDL_SCANCODE_UNKNOWN && e.key.keysym.scancode == buildingHotkeys[i]) {
+                    triggerBuild(static_cast<int>(i));
+                    break;
                 }
             }
+            for (size_t i = 0; i < um.upgrades.size() && i < upgradeKeyPool.size(); ++i) {
+                if (e.key.keysym.scancode == upgradeKeyPool[i]) {
+                    if (!um.canBuy(static_cast<int>(i), rm)) break;
+                    history.capture(rm, bm, um, gameTime, "achat");
+                    if (um.tryBuy(static_cast<int>(i), rm)) purchases.push_back(Purchase{ static_cast<int>(i), Entity{}, {} });
+                    break;
+                }
+            }
+            if (e.key.keysym.scancode == SDL_SCANCODE_BACKSPACE) {
+                // N'annule que le dernier achat encore en place, sans toucher au reste de la partie.
+                while (!purchases.empty()) {
+                    const Purchase p = purchases.back();
+                    purchases.pop_back();
+                    if (p.upgrade >= 0 ? um.refund(p.upgrade, rm) : bm.refund(p.building, p.paid, rm)) break;
+                }
+            }
+            if (e.key.keysym.scancode == SDL_SCANCODE_PAGEUP && history.size() > 0) {
+                int index = static_cast<int>(history.size()) - 1;
+                if (index > 0 && history.at(static_cast<size_t>(index)).time >= gameTime) --index;
+                restoreSnapshot(index);
+            }
+        }
+    };
+
+    while (run) {
+        int waitMs = 0;
+        if (hidden) {
+            waitMs = hiddenWakeMs;
+        } else if (!needsRedraw) {
+            waitMs = static_cast<int>(std::ceil(std::max(0.0, dt - acc) * 1000.0));
+        }
+        SDL_Event e;
+        bool got = waitMs > 0 ? SDL_WaitEventTimeout(&e, waitMs) != 0 : SDL_PollEvent(&e) != 0;
+        while (got) {
+            handleEvent(e);
+            got = SDL_PollEvent(&e) != 0;
         }
 
         auto now = std::chrono::high_resolution_clock::now();
@@ -484,20 +520,26 @@ int main(int argc, char* argv[]) {
         acc += frame;
         title_acc += frame;
 
+        um.modifiers.refresh(bm.prototypes);
+
         int ticks = 0;
-        while (acc >= dt && ticks < 10) {
+        while (acc >= dt && (hidden || ticks < 10)) {
+            telemetry.beginTick(rm);
             bm.produceAll(rm, dt);
-            auto popIt = rm.resources.find("pop");
-            auto foodIt = rm.resources.find("food");
-            if (popIt != rm.resources.end() && foodIt != rm.resources.end()) {
-                double need = popIt->second.qty * 0.02 * dt;
-                if (foodIt->second.qty >= need) {
-                    foodIt->second.qty -= need;
-                }
+            rules.apply(rm, bm.prototypes, dt);
+            telemetry.record(rm);
+            gameTime += dt;
+            if (gameTime >= nextAutoSnapshot) {
+                history.capture(rm, bm, um, gameTime, "auto");
+                nextAutoSnapshot += autoSnapshotPeriod;
+            }
+            if (qm.update(rm, bm.prototypes) > 0) {
+                for (int q : qm.completedNow) std::printf("Succes: %s\n", qm.quests[q].name.c_str());
             }
             acc -= dt;
             ++ticks;
         }
+        if (ticks > 0 && stateChanged()) needsRedraw = true;
 
         if (title_acc >= 0.5) {
             std::ostringstream os;
@@ -524,6 +566,9 @@ int main(int argc, char* argv[]) {
             title_acc = 0.0;
         }
 
+        if (hidden || !needsRedraw) continue;
+        needsRedraw = false;
+
         SDL_SetRenderDrawColor(ren, 20, 18, 28, 255);
         SDL_RenderClear(ren);
 
@@ -549,6 +594,12 @@ int main(int argc, char* argv[]) {
             }
             draw_text(ren, resourcePanel.x + 16, barY + 2, label, labelColor, 2);
             draw_bar(ren, barStartX, barY, barWidth, barHeight, res.qty, res.qmin, maxv);
+            int sparkHeight = std::min(40, barSpacing - barHeight - 12);
+            if (sparkHeight >= 8) {
+                telemetry.history(historyTier, rm.indexOf(id), historyScratch);
+                SDL_Rect spark{ barStartX, barY + barHeight + 4, barWidth, sparkHeight };
+                draw_sparkline(ren, spark, historyScratch, telemetry.capacity(historyTier));
+            }
             barY += barSpacing;
         }
 
@@ -618,26 +669,33 @@ int main(int argc, char* argv[]) {
             draw_text(ren, cardRect.x + 8, textY, "Cout: " + join_costs(nextCost), costColor, 2);
 
             textY += 18;
-            draw_text(ren, cardRect.x + 8, textY, "Conso: " + join_rates(proto.inputs, proto.count, false), bodyColor, 2);
+            draw_text(ren, cardRect.x + 8, textY, "Conso: " + join_rates(proto, bm.unitsOf(static_cast<int>(i)), false), bodyColor, 2);
 
             textY += 18;
-            draw_text(ren, cardRect.x + 8, textY, "Prod: " + join_rates(proto.outputs, proto.count, true), bodyColor, 2);
+            draw_text(ren, cardRect.x + 8, textY, "Prod: " + join_rates(proto, bm.unitsOf(static_cast<int>(i)), true), bodyColor, 2);
         }
 
         draw_panel(ren, yardArea, SDL_Color{ 22, 36, 40, 255 }, SDL_Color{ 80, 110, 110, 255 });
         draw_text(ren, yardArea.x + 12, yardArea.y + 8, "PLACEMENTS", SDL_Color{ 190, 210, 210, 255 }, 2);
 
         for (size_t i = 0; i < bm.prototypes.size(); ++i) {
-            SDL_Point anchor = anchorForIndex(static_cast<int>(i));
-            SDL_Rect slotRect{ anchor.x, anchor.y, yardSlotSize, yardSlotSize };
+            const YardPoint anchor = yard.anchor(static_cast<int>(i));
+            SDL_Rect slotRect{ anchor.x, anchor.y, YardLayout::slotSize, YardLayout::slotSize };
             SDL_SetRenderDrawColor(ren, 70, 80, 92, 255);
             SDL_RenderDrawRect(ren, &slotRect);
         }
 
         bm.render(ren);
 
+        if (!qm.quests.empty()) {
+            std::ostringstream questLine;
+            questLine << "SUCCES " << qm.completedCount() << '/' << qm.quests.size();
+            if (qm.lastCompleted >= 0) questLine << ": " << qm.quests[qm.lastCompleted].name;
+            draw_text(ren, yardArea.x + 12, yardArea.y + yardArea.h - 24, questLine.str(), SDL_Color{ 230, 210, 150, 255 }, 2);
+        }
+
         for (size_t i = 0; i < bm.prototypes.size(); ++i) {
-            SDL_Point anchor = anchorForIndex(static_cast<int>(i));
+            const YardPoint anchor = yard.anchor(static_cast<int>(i));
             bool canBuild = bm.prototypes[i].canAfford(rm.resources);
             SDL_Color label = canBuild ? SDL_Color{ 220, 235, 210, 255 } : SDL_Color{ 220, 170, 170, 255 };
             draw_text(ren, anchor.x, anchor.y - 18, "[" + buildingKeyLabels[i] + "]", label, 2);
@@ -654,12 +712,24 @@ int main(int argc, char* argv[]) {
         } else {
             hintLines.push_back("Pret: " + readyList.str());
         }
-        hintLines.push_back("Esc pour quitter. Les jauges s adaptent a vos stocks.");
+        hintLines.push_back("Esc: quitter. Tab: historique (" + telemetry.tierLabel(historyTier) + "). Retour: annuler achat. PgUp: rembobiner.");
+
+        std::ostringstream upgradeList;
+        bool firstUpgrade = true;
+        for (size_t i = 0; i < um.upgrades.size() && i < upgradeKeyPool.size(); ++i) {
+            const Upgrade& u = um.upgrades[i];
+            if (u.bought) continue;
+            upgradeList << (firstUpgrade ? "Ameliorations: " : ", ");
+            upgradeList << '[' << SDL_GetScancodeName(upgradeKeyPool[i]) << "] " << u.name << " (" << join_costs(u.cost) << ')';
+            firstUpgrade = false;
+        }
+        if (!firstUpgrade) hintLines.push_back(upgradeList.str());
 
-        int hintY = hintPanel.y + 16;
+        const int hintStep = hintLines.size() > 4 ? 16 : 18;
+        int hintY = hintPanel.y + (hintLines.size() > 4 ? 6 : 16);
         for (const auto& line : hintLines) {
             draw_text(ren, hintPanel.x + 16, hintY, line, SDL_Color{ 200, 205, 220, 255 }, 2);
-            hintY += 18;
+            hintY += hintStep;
         }
 
         SDL_RenderPresent(ren);
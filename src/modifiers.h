@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "building.h"
+
+enum class ModTarget { Output, Input, Cost };
+
+// building/res vides = s'applique a tous les batiments/toutes les ressources.
+struct Modifier {
+    std::string source;
+    std::string building;
+    std::string res;
+    ModTarget target = ModTarget::Output;
+    double add = 0.0;
+    double mul = 1.0;
+};
+
+// Agrege les modificateurs en un coefficient par (batiment, ressource, cible),
+// stocke dans Building::*Factor. Seuls les batiments touches par un
+// changement sont recalcules au prochain refresh().
+class ModifierSet {
+public:
+    std::vector<Modifier> modifiers;
+
+    void add(const Modifier& m) {
+        modifiers.push_back(m);
+        markDirty(m);
+    }
+
+    void removeSource(const std::string& source) {
+        for (size_t i = 0; i < modifiers.size();) {
+            if (modifiers[i].source == source) {
+                markDirty(modifiers[i]);
+                modifiers.erase(modifiers.begin() + static_cast<long>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void markAllDirty() { allDirty = true; }
+    bool dirty() const { return allDirty || !dirtyBuildings.empty(); }
+
+    void refresh(std::vector<Building>& buildings) {
+        if (!dirty()) return;
+        for (auto& b : buildings) {
+            if (allDirty || isDirty(b.id)) recompute(b);
+        }
+        allDirty = false;
+        dirtyBuildings.clear();
+    }
+
+private:
+    bool allDirty = true;
+    std::vector<std::string> dirtyBuildings;
+
+    void markDirty(const Modifier& m) {
+        if (m.building.empty()) {
+            allDirty = true;
+        } else if (!isDirty(m.building)) {
+            dirtyBuildings.push_back(m.building);
+        }
+    }
+
+    bool isDirty(const std::string& id) const {
+        for (const auto& d : dirtyBuildings) {
+            if (d == id) return true;
+        }
+        return false;
+    }
+
+    double factorFor(const Building& b, ModTarget target, const std::string& res) const {
+        double additive = 1.0;
+        double multiplicative = 1.0;
+        for (const auto& m : modifiers) {
+            if (m.target != target) continue;
+            if (!m.building.empty() && m.building != b.id) continue;
+            if (!m.res.empty() && m.res != res) continue;
+            additive += m.add;
+            multiplicative *= m.mul;
+        }
+        double f = additive * multiplicative;
+        return f > 0.0 ? f : 0.0;
+    }
+
+    void recompute(Building& b) const {
+        b.resetFactors();
+        for (size_t k = 0; k < b.base_cost.size(); ++k) b.costFactor[k] = factorFor(b, ModTarget::Cost, b.base_cost[k].res);
+        for (size_t k = 0; k < b.inputs.size(); ++k) b.inputFactor[k] = factorFor(b, ModTarget::Input, b.inputs[k].res);
+        for (size_t k = 0; k < b.outputs.size(); ++k) b.outputFactor[k] = factorFor(b, ModTarget::Output, b.outputs[k].res);
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
+#include "simulation.h"
+#include "thread_pool.h"
+
+struct PlanGoal {
+    std::vector<RuleTerm> targets;
+
+    bool reached(const EconomyState& s) const {
+        for (const auto& t : targets) {
+            if (s.values[t.res] < t.qty) return false;
+        }
+        return true;
+    }
+
+    double progress(const EconomyState& s) const {
+        if (targets.empty()) return 1.0;
+        double sum = 0.0;
+        for (const auto& t : targets) {
+            sum += t.qty > 0.0 ? std::min(1.0, s.values[t.res] / t.qty) : 1.0;
+        }
+        return sum / static_cast<double>(targets.size());
+    }
+};
+
+struct PlanStep {
+    int building;
+    double time;
+};
+
+struct Plan {
+    std::vector<PlanStep> steps;
+    double finishTime = std::numeric_limits<double>::infinity();
+    bool reached = false;
+};
+
+struct PlannerOptions {
+    int beamWidth = 24;
+    int maxDepth = 32;
+    double step = 0.5;
+    double horizon = 4.0 * 3600.0;
+};
+
+// Recherche en faisceau sur les ordres de construction. Chaque candidat
+// (noeud du faisceau x batiment) est evalue par simulation : attendre de
+// pouvoir payer, acheter, puis attendre l'objectif sans rien acheter d'autre.
+class BuildOrderPlanner {
+public:
+    BuildOrderPlanner(const EconomyModel& m, ThreadPool& p, PlannerOptions o = {})
+        : model(m), pool(p), opts(o) {}
+
+    Plan plan(const EconomyState& start, const PlanGoal& goal) const {
+        Node root{ start, {}, 0.0, false };
+        root.score = finishScore(start, goal, opts.horizon, root.reached);
+
+        Plan best;
+        best.finishTime = root.score;
+        best.reached = root.reached;
+
+        std::vector<Node> beam{ root };
+        const int buildingCount = static_cast<int>(model.buildings.size());
+
+        for (int depth = 0; depth < opts.maxDepth && !beam.empty() && buildingCount > 0; ++depth) {
+            const double deadline = std::min(best.finishTime, opts.horizon);
+            std::vector<Node> children(beam.size() * static_cast<size_t>(buildingCount));
+            std::vector<char> valid(children.size(), 0);
+
+            pool.parallelFor(children.size(), [&](size_t i) {
+                const Node& parent = beam[i / buildingCount];
+                const int b = static_cast<int>(i % buildingCount);
+                Node child{ parent.state, parent.steps, 0.0, false };
+                if (!waitUntilAffordable(child.state, b, deadline)) return;
+                model.buy(child.state, b);
+                child.steps.push_back({ b, child.state.time });
+                child.score = finishScore(child.state, goal, deadline, child.reached);
+                children[i] = std::move(child);
+                valid[i] = 1;
+            });
+
+            // Deux ordres menant aux memes effectifs ne different que par le temps.
+            std::map<std::vector<int>, size_t> seen;
+            std::vector<Node> next;
+            for (size_t i = 0; i < children.size(); ++i) {
+                if (!valid[i]) continue;
+                Node& c = children[i];
+                if (c.reached && c.score < best.finishTime) {
+                    best.finishTime = c.score;
+                    best.reached = true;
+                    best.steps = c.steps;
+                }
+                auto it = seen.find(c.state.counts);
+                if (it == seen.end()) {
+                    seen.emplace(c.state.counts, next.size());
+                    next.push_back(std::move(c));
+                } else if (c.score < next[it->second].score) {
+                    next[it->second] = std::move(c);
+                }
+            }
+
+            std::sort(next.begin(), next.end(), [](const Node& a, const Node& b) {
+                if (a.score != b.score) return a.score < b.score;
+                return a.state.time < b.state.time;
+            });
+            if (static_cast<int>(next.size()) > opts.beamWidth) next.resize(static_cast<size_t>(opts.beamWidth));
+            beam = std::move(next);
+        }
+
+        if (!best.reached) best.finishTime = std::numeric_limits<double>::infinity();
+        return best;
+    }
+
+private:
+    struct Node {
+        EconomyState state;
+        std::vector<PlanStep> steps;
+        double score = 0.0;
+        bool reached = false;
+    };
+
+    const EconomyModel& model;
+    ThreadPool& pool;
+    PlannerOptions opts;
+
+    bool waitUntilAffordable(EconomyState& s, int b, double deadline) const {
+        while (!model.canAfford(s, b)) {
+            if (s.time >= deadline) return false;
+            model.step(s, opts.step);
+        }
+        return s.time < deadline;
+    }
+
+    // Instant d'atteinte de l'objectif; au-dela de `limit`, limit + manque
+    // relatif pour continuer a departager les candidats.
+    double finishScore(EconomyState s, const PlanGoal& goal, double limit, bool& reached) const {
+        reached = false;
+        while (!goal.reached(s)) {
+            if (s.time >= limit) return limit + (1.0 - goal.progress(s));
+            model.step(s, opts.step);
+        }
+        reached = true;
+        return s.time;
+    }
+};
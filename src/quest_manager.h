@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "building.h"
+#include "conditions.h"
+#include "resource_manager.h"
+
+// Une condition de quete telle que lue dans data/quests.json.
+struct QuestCondition {
+    std::string res;
+    std::string building;
+    CmpOp op = CmpOp::Ge;
+    double value = 0.0;
+};
+
+struct Quest {
+    std::string id, name;
+    std::vector<QuestCondition> all;
+    bool completed = false;
+};
+
+// Variables du moteur : ressources (index de ResourceManager) puis
+// effectifs de batiments decales du nombre de ressources.
+class QuestManager {
+public:
+    std::vector<Quest> quests;
+    ConditionEngine engine;
+    std::vector<ConditionEvent> events;
+    // Quetes terminees pendant le dernier update(), dans l'ordre des evenements.
+    std::vector<int> completedNow;
+    int lastCompleted = -1;
+
+    void addQuest(const Quest& q) { quests.push_back(q); }
+
+    // Une quete dont une condition ne se resout pas est ecartee : ignorer la
+    // condition seule la rendrait plus facile, voire acquise d'office.
+    void compile(const ResourceManager& rm, const std::vector<Building>& buildings) {
+        engine = ConditionEngine();
+        resourceCount = rm.size();
+        std::vector<Quest> kept;
+        for (auto& q : quests) {
+            std::vector<ConditionAtom> atoms;
+            const QuestCondition* unknown = nullptr;
+            for (const auto& c : q.all) {
+                int var = -1;
+                if (!c.res.empty()) {
+                    var = rm.indexOf(c.res);
+                } else {
+                    for (size_t b = 0; b < buildings.size(); ++b) {
+                        if (buildings[b].id == c.building) var = resourceCount + static_cast<int>(b);
+                    }
+                }
+                if (var < 0) {
+                    unknown = &c;
+                    break;
+                }
+                atoms.push_back({ var, c.op, c.value });
+            }
+            if (unknown) {
+                if (unknown->res.empty()) {
+                    std::printf("Avertissement: quete %s ignoree (batiment inconnu: %s)\n", q.id.c_str(), unknown->building.c_str());
+                } else {
+                    std::printf("Avertissement: quete %s ignoree (ressource inconnue: %s)\n", q.id.c_str(), unknown->res.c_str());
+                }
+                continue;
+            }
+            if (atoms.empty()) {
+                std::printf("Avertissement: quete %s ignoree (aucune condition)\n", q.id.c_str());
+                continue;
+            }
+            engine.addCondition(q.id, atoms);
+            kept.push_back(std::move(q));
+        }
+        quests = std::move(kept);
+    }
+
+    // Retourne le nombre de quetes terminees pendant cet appel.
+    int update(const ResourceManager& rm, const std::vector<Building>& buildings) {
+        events.clear();
+        completedNow.clear();
+        engine.sync([&](int var) {
+            if (var < resourceCount) return rm.at(var).qty;
+            return static_cast<double>(buildings[var - resourceCount].count);
+        }, events);
+        int done = 0;
+        for (const auto& e : events) {
+            Quest& q = quests[e.condition];
+            if (e.satisfied && !q.completed) {
+                q.completed = true;
+                lastCompleted = e.condition;
+                completedNow.push_back(e.condition);
+                ++done;
+            }
+        }
+        return done;
+    }
+
+    int completedCount() const {
+        int n = 0;
+        for (const auto& q : quests) n += q.completed ? 1 : 0;
+        return n;
+    }
+
+private:
+    int resourceCount = 0;
+};
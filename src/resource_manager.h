@@ -10,15 +10,41 @@ public:
     std::unordered_map<std::string, Resource> resources;
     std::vector<std::string> order;
 
+    ResourceManager() = default;
+    ResourceManager(const ResourceManager& o) : resources(o.resources), order(o.order) { reindex(); }
+    ResourceManager(ResourceManager&&) = default;
+    ResourceManager& operator=(const ResourceManager& o) {
+        if (this != &o) {
+            resources = o.resources;
+            order = o.order;
+            reindex();
+        }
+        return *this;
+    }
+    ResourceManager& operator=(ResourceManager&&) = default;
+
     Resource& ensureResource(const std::string& id) {
         auto [it, inserted] = resources.try_emplace(id);
         if (inserted) {
             it->second.id = id;
             order.push_back(id);
+            slots.push_back(&it->second);
         }
         return it->second;
     }
 
+    // Index stable = position dans `order`, pour les noyaux compiles.
+    int indexOf(const std::string& id) const {
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (order[i] == id) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    Resource& at(int index) { return *slots[index]; }
+    const Resource& at(int index) const { return *slots[index]; }
+    int size() const { return static_cast<int>(slots.size()); }
+
     Resource& get(const std::string& id) { return ensureResource(id); }
 
     const Resource* find(const std::string& id) const {
@@ -49,4 +75,13 @@ public:
         r.qty += qty;
         if (r.qmax > 0 && r.qty > r.qmax) r.qty = r.qmax;
     }
+
+private:
+    std::vector<Resource*> slots;
+
+    void reindex() {
+        slots.clear();
+        slots.reserve(order.size());
+        for (const auto& id : order) slots.push_back(&resources.find(id)->second);
+    }
 };
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "building.h"
+#include "resource_manager.h"
+
+// Regle telle que lue dans data/rules.json.
+//  - conversion : par unite de `per` (ressource) ou de `per_building` (batiment),
+//    consomme `inputs` et produit `outputs` chaque seconde.
+//  - plafond : qmax de `cap` = base + qty * nombre de `per_building`.
+struct Rule {
+    std::string id;
+    std::string per;
+    std::string perBuilding;
+    std::vector<Cost> inputs;
+    std::vector<Cost> outputs;
+    std::string cap;
+    double base = 0.0;
+    double qty = 0.0;
+};
+
+struct RuleTerm {
+    int res;
+    double qty;
+};
+
+struct ConversionKernel {
+    int perRes = -1;
+    int perBuilding = -1;
+    std::vector<RuleTerm> inputs;
+    std::vector<RuleTerm> outputs;
+};
+
+struct CapKernel {
+    int res;
+    int perBuilding;
+    double base;
+    double perUnit;
+};
+
+// Meme semantique que Building::produce : tout ou rien sur les entrees.
+// `multiplier` = dt * nombre d'unites.
+template <class Economy>
+void convert(const ConversionKernel& k, Economy& e, double multiplier) {
+    if (multiplier <= 0.0) return;
+    for (const auto& t : k.inputs) {
+        if (e.qty(t.res) < t.qty * multiplier) return;
+    }
+    for (const auto& t : k.inputs) e.qty(t.res) -= t.qty * multiplier;
+    for (const auto& t : k.outputs) e.qty(t.res) += t.qty * multiplier;
+}
+
+template <class Economy>
+void runConversion(const ConversionKernel& k, Economy& e, double dt) {
+    double scale = 1.0;
+    if (k.perRes >= 0) scale *= e.qty(k.perRes);
+    if (k.perBuilding >= 0) scale *= static_cast<double>(e.count(k.perBuilding));
+    convert(k, e, dt * scale);
+}
+
+// Vue sur l'etat en jeu pour RuleSet::apply.
+struct LiveEconomy {
+    ResourceManager& rm;
+    const std::vector<Building>& buildings;
+
+    double& qty(int r) { return rm.at(r).qty; }
+    double& qmax(int r) { return rm.at(r).qmax; }
+    int count(int b) const { return buildings[b].count; }
+};
+
+class RuleSet {
+public:
+    std::vector<Rule> rules;
+    std::vector<ConversionKernel> conversions;
+    std::vector<CapKernel> caps;
+
+    void addRule(const Rule& r) { rules.push_back(r); }
+
+    // Resout les noms en index une seule fois; a rappeler si les donnees changent.
+    // Une regle qui nomme un batiment ou une ressource inconnus est ecartee :
+    // creer la ressource ferait apparaitre et consommer une faute de frappe.
+    void compile(const ResourceManager& rm, const std::vector<Building>& buildings) {
+        conversions.clear();
+        caps.clear();
+        auto buildingIndex = [&](const std::string& id) {
+            for (size_t i = 0; i < buildings.size(); ++i) {
+                if (buildings[i].id == id) return static_cast<int>(i);
+            }
+            return -1;
+        };
+
+        for (const auto& r : rules) {
+            int perBuilding = -1;
+            if (!r.perBuilding.empty()) {
+                perBuilding = buildingIndex(r.perBuilding);
+                if (perBuilding < 0) {
+                    std::printf("Avertissement: regle %s ignoree (batiment inconnu: %s)\n", r.id.c_str(), r.perBuilding.c_str());
+                    continue;
+                }
+            }
+            const std::string* unknown = nullptr;
+            auto resourceIndex = [&](const std::string& id) {
+                const int index = rm.indexOf(id);
+                if (index < 0 && !unknown) unknown = &id;
+                return index;
+            };
+
+            if (!r.cap.empty()) {
+                const int res = resourceIndex(r.cap);
+                if (unknown) {
+                    std::printf("Avertissement: regle %s ignoree (ressource inconnue: %s)\n", r.id.c_str(), unknown->c_str());
+                    continue;
+                }
+                caps.push_back({ res, perBuilding, r.base, r.qty });
+                continue;
+            }
+            ConversionKernel k;
+            k.perBuilding = perBuilding;
+            if (!r.per.empty()) k.perRes = resourceIndex(r.per);
+            for (const auto& c : r.inputs) {
+                if (!c.res.empty()) k.inputs.push_back({ resourceIndex(c.res), c.qty });
+            }
+            for (const auto& c : r.outputs) {
+                if (!c.res.empty()) k.outputs.push_back({ resourceIndex(c.res), c.qty });
+            }
+            if (unknown) {
+                std::printf("Avertissement: regle %s ignoree (ressource inconnue: %s)\n", r.id.c_str(), unknown->c_str());
+                continue;
+            }
+            if (!k.inputs.empty() || !k.outputs.empty()) conversions.push_back(std::move(k));
+        }
+    }
+
+    template <class Economy>
+    void apply(Economy& e, double dt) const {
+        for (const auto& k : conversions) runConversion(k, e, dt);
+
+        for (const auto& c : caps) {
+            double cap = c.base;
+            if (c.perBuilding >= 0) cap += c.perUnit * static_cast<double>(e.count(c.perBuilding));
+            e.qmax(c.res) = cap;
+            double& q = e.qty(c.res);
+            if (cap > 0.0 && q > cap) q = cap;
+        }
+    }
+
+    void apply(ResourceManager& rm, const std::vector<Building>& buildings, double dt) const {
+        LiveEconomy e{ rm, buildings };
+        apply(e, dt);
+    }
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <vector>
+#include "adjacency.h"
+#include "building.h"
+#include "resource_manager.h"
+#include "rules.h"
+#include "yard_layout.h"
+
+// Etat compact de l'economie, copiable a bas cout pour la simulation hors-jeu.
+// Les index de ressources sont ceux de ResourceManager::order, ceux des
+// batiments ceux de BuildingManager::prototypes.
+struct EconomyState {
+    std::vector<double> values;
+    std::vector<double> caps;
+    std::vector<int> counts;
+    // Unites productives par batiment : effectif pondere par le voisinage, comme BuildingManager::units.
+    std::vector<double> units;
+    // Par batiment cible, par instance : sources dans le rayon de chaque regle
+    // (Adjacency::kMaxRules entrees par instance), comme la colonne Adjacency.
+    std::vector<std::vector<int>> near;
+    double time = 0.0;
+
+    double& qty(int r) { return values[r]; }
+    double qty(int r) const { return values[r]; }
+    double& qmax(int r) { return caps[r]; }
+    int count(int b) const { return counts[b]; }
+};
+
+struct BuildingKernel {
+    ConversionKernel production;
+    std::vector<RuleTerm> cost;
+    double growth = 1.15;
+};
+
+// Regles de l'economie compilees en index : production des batiments (avec
+// leurs coefficients de modificateurs courants) puis regles de data/rules.json,
+// dans le meme ordre que la boucle du jeu. Les instances sont supposees posees
+// comme en jeu (YardLayout) et a efficacite nominale; leur voisinage suit
+// `adjacency`, a renseigner avant capture().
+class EconomyModel {
+public:
+    std::vector<std::string> resourceIds;
+    std::vector<std::string> buildingIds;
+    std::vector<BuildingKernel> buildings;
+    RuleSet rules;
+    std::vector<AdjacencyTerm> adjacency;
+    YardLayout yard;
+
+    // `rules` doit deja etre compile contre `rm` et `protos`.
+    EconomyModel(const ResourceManager& rm, const std::vector<Building>& protos, const RuleSet& compiled)
+        : resourceIds(rm.order), rules(compiled), yard(protos.size()) {
+        for (const auto& b : protos) {
+            BuildingKernel k;
+            k.growth = b.growth;
+            for (size_t i = 0; i < b.inputs.size(); ++i) {
+                int r = rm.indexOf(b.inputs[i].res);
+                if (r >= 0) k.production.inputs.push_back({ r, b.inputRate(i) });
+            }
+            for (size_t i = 0; i < b.outputs.size(); ++i) {
+                int r = rm.indexOf(b.outputs[i].res);
+                if (r >= 0) k.production.outputs.push_back({ r, b.outputRate(i) });
+            }
+            for (size_t i = 0; i < b.base_cost.size(); ++i) {
+                int r = rm.indexOf(b.base_cost[i].res);
+                if (r >= 0) k.cost.push_back({ r, b.base_cost[i].qty * b.costFactor[i] });
+            }
+            buildingIds.push_back(b.id);
+            buildings.push_back(std::move(k));
+        }
+    }
+
+    EconomyState capture(const ResourceManager& rm, const std::vector<Building>& protos) const {
+        EconomyState s;
+        s.values.resize(resourceIds.size());
+        s.caps.resize(resourceIds.size());
+        for (size_t r = 0; r < resourceIds.size(); ++r) {
+            s.values[r] = rm.at(static_cast<int>(r)).qty;
+            s.caps[r] = rm.at(static_cast<int>(r)).qmax;
+        }
+        s.counts.assign(protos.size(), 0);
+        s.units.assign(protos.size(), 0.0);
+        s.near.assign(protos.size(), {});
+        for (size_t b = 0; b < protos.size(); ++b) {
+            for (int i = 0; i < protos[b].count; ++i) place(s, static_cast<int>(b));
+        }
+        return s;
+    }
+
+    int resourceIndex(const std::string& id) const {
+        for (size_t i = 0; i < resourceIds.size(); ++i) {
+            if (resourceIds[i] == id) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    int buildingIndex(const std::string& id) const {
+        for (size_t i = 0; i < buildingIds.size(); ++i) {
+            if (buildingIds[i] == id) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void step(EconomyState& s, double dt) const {
+        for (size_t b = 0; b < buildings.size(); ++b) convert(buildings[b].production, s, dt * s.units[b]);
+        rules.apply(s, dt);
+        s.time += dt;
+    }
+
+    bool canAfford(const EconomyState& s, int b) const {
+        const BuildingKernel& k = buildings[b];
+        const double scale = std::pow(k.growth, s.counts[b]);
+        for (const auto& c : k.cost) {
+            if (s.values[c.res] < c.qty * scale) return false;
+        }
+        return true;
+    }
+
+    bool buy(EconomyState& s, int b) const {
+        if (!canAfford(s, b)) return false;
+        const BuildingKernel& k = buildings[b];
+        const double scale = std::pow(k.growth, s.counts[b]);
+        for (const auto& c : k.cost) s.values[c.res] -= c.qty * scale;
+        place(s, b);
+        return true;
+    }
+
+private:
+    static constexpr int kSlots = Adjacency::kMaxRules;
+
+    // Pose la prochaine instance de `b` a sa place dans le chantier. Seules
+    // les instances dans le rayon d'une regle sont visitees : ses propres
+    // compteurs, et +1 sur ceux des cibles dont elle est source.
+    void place(EconomyState& s, int b) const {
+        const int n = s.counts[b]++;
+        const YardPoint p = yard.instance(b, n);
+        std::vector<int>& own = s.near[b];
+        for (const auto& t : adjacency) {
+            if (t.target == b) {
+                own.resize(static_cast<size_t>(s.counts[b]) * kSlots, 0);
+                break;
+            }
+        }
+        double bonus = 0.0;
+        for (const auto& t : adjacency) {
+            if (t.target == b) {
+                int count = 0;
+                yard.forEachNear(t.source, s.counts[t.source], p, t.radius2, [&](int j) {
+                    if (t.source != b || j != n) ++count;
+                });
+                own[static_cast<size_t>(n) * kSlots + t.slot] = count;
+                bonus += t.bonusFor(count);
+            }
+            if (t.source == b) {
+                std::vector<int>& near = s.near[t.target];
+                yard.forEachNear(t.target, s.counts[t.target], p, t.radius2, [&](int i) {
+                    if (t.target == b && i == n) return;
+                    int& c = near[static_cast<size_t>(i) * kSlots + t.slot];
+                    s.units[t.target] += t.bonusFor(c + 1) - t.bonusFor(c);
+                    ++c;
+                });
+            }
+        }
+        s.units[b] += 1.0 + bonus;
+    }
+};
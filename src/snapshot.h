@@ -0,0 +1,331 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "building_manager.h"
+#include "ecs.h"
+#include "resource_manager.h"
+#include "upgrade_manager.h"
+
+// Bloc immuable partage entre instantanes.
+struct StateChunk {
+    std::vector<unsigned char> bytes;
+};
+
+using ChunkRef = std::shared_ptr<const StateChunk>;
+
+// Suite d'octets decoupee en blocs; deux segments partagent les blocs identiques.
+struct StateSegment {
+    size_t bytes = 0;
+    std::vector<ChunkRef> chunks;
+};
+
+struct ArchetypeImage {
+    ComponentMask mask = 0;
+    StateSegment entities;
+    std::vector<StateSegment> columns;
+};
+
+struct StateSnapshot {
+    double time = 0.0;
+    std::string reason;
+    StateSegment resources;
+    StateSegment counts;
+    StateSegment upgrades;
+    StateSegment records;
+    StateSegment freeList;
+    size_t liveCount = 0;
+    std::vector<ArchetypeImage> archetypes;
+
+    const ArchetypeImage* findArchetype(ComponentMask mask) const {
+        for (const auto& a : archetypes) {
+            if (a.mask == mask) return &a;
+        }
+        return nullptr;
+    }
+};
+
+// Historique glissant d'etats de jeu en blocs copie-sur-ecriture. `live`
+// decrit l'etat en jeu lors de la derniere capture ou restauration; les
+// lignes marquees depuis par World (DirtyRows) designent les seuls blocs a
+// reexaminer. Capture et restauration coutent donc O(blocs modifies), plus
+// un parcours des pointeurs de blocs. Un seul historique par World, car il
+// en remet les marques a zero.
+class StateHistory {
+public:
+    static constexpr size_t kChunkBytes = 4096;
+
+    explicit StateHistory(size_t capacity = 256) : capacity(capacity) {}
+
+    size_t size() const { return history.size(); }
+    const StateSnapshot& at(size_t i) const { return history[i]; }
+
+    void capture(const ResourceManager& rm, BuildingManager& bm, const UpgradeManager& um,
+                 double time, const std::string& reason) {
+        StateSnapshot s;
+        encodeState(rm, bm, um, hasLive ? &live : nullptr, s);
+        bm.instances.clearDirty();
+        s.time = time;
+        s.reason = reason;
+        live = s;
+        hasLive = true;
+        history.push_back(std::move(s));
+        while (history.size() > capacity) history.pop_front();
+    }
+
+    // Restaure l'instantane i et oublie ceux qui le suivent.
+    bool restore(size_t i, ResourceManager& rm, BuildingManager& bm, UpgradeManager& um) {
+        if (i >= history.size()) return false;
+        StateSnapshot current;
+        encodeState(rm, bm, um, hasLive ? &live : nullptr, current);
+        const StateSnapshot& target = history[i];
+
+        // Les tampons partent de l'etat courant pour que les blocs partages soient deja en place.
+        std::vector<double> res(rm.size() * 2);
+        for (int r = 0; r < rm.size(); ++r) {
+            res[2 * r] = rm.at(r).qty;
+            res[2 * r + 1] = rm.at(r).qmax;
+        }
+        decode(target.resources, &current.resources, res.data(), res.size() * sizeof(double));
+        for (int r = 0; r < rm.size(); ++r) {
+            rm.at(r).qty = res[2 * r];
+            rm.at(r).qmax = res[2 * r + 1];
+        }
+
+        std::vector<int> counts(bm.prototypes.size());
+        for (size_t b = 0; b < counts.size(); ++b) counts[b] = bm.prototypes[b].count;
+        decode(target.counts, &current.counts, counts.data(), counts.size() * sizeof(int));
+        for (size_t b = 0; b < counts.size(); ++b) bm.prototypes[b].count = counts[b];
+
+        std::vector<char> bought(um.upgrades.size());
+        for (size_t u = 0; u < bought.size(); ++u) bought[u] = um.upgrades[u].bought ? 1 : 0;
+        decode(target.upgrades, &current.upgrades, bought.data(), bought.size());
+        for (size_t u = 0; u < bought.size(); ++u) {
+            Upgrade& up = um.upgrades[u];
+            if (up.bought == (bought[u] != 0)) continue;
+            up.bought = bought[u] != 0;
+            if (up.bought) {
+                for (auto m : up.modifiers) {
+                    m.source = up.id;
+                    um.modifiers.add(m);
+                }
+            } else {
+                um.modifiers.removeSource(up.id);
+            }
+        }
+
+        restoreWorld(bm, target, current);
+        bm.instances.clearDirty();
+        live = target;
+
+        dropFrom(i + 1);
+        return true;
+    }
+
+    void dropFrom(size_t i) {
+        if (i < history.size()) history.erase(history.begin() + static_cast<long>(i), history.end());
+    }
+
+    // Octets reellement occupes par les blocs distincts de tout l'historique.
+    size_t uniqueBytes() const {
+        std::vector<const StateChunk*> seen;
+        auto visit = [&](const StateSegment& s) {
+            for (const auto& c : s.chunks) seen.push_back(c.get());
+        };
+        for (const auto& h : history) {
+            visit(h.resources);
+            visit(h.counts);
+            visit(h.upgrades);
+            visit(h.records);
+            visit(h.freeList);
+            for (const auto& a : h.archetypes) {
+                visit(a.entities);
+                for (const auto& c : a.columns) visit(c);
+            }
+        }
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+        size_t total = 0;
+        for (const auto* c : seen) total += c->bytes.size();
+        return total;
+    }
+
+private:
+    size_t capacity;
+    std::deque<StateSnapshot> history;
+    StateSnapshot live;
+    bool hasLive = false;
+
+    // Avec `dirty`, un bloc de meme taille sans ligne marquee est repris de
+    // `prev` sans comparaison; les autres sont compares puis partages ou recopies.
+    static void encode(const void* data, size_t n, size_t elementSize, const StateSegment* prev,
+                       const DirtyRows* dirty, StateSegment& out) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const size_t chunkCount = (n + kChunkBytes - 1) / kChunkBytes;
+        std::vector<char> touched;
+        const bool trusted = prev && dirty && !dirty->all;
+        if (trusted) {
+            touched.assign(chunkCount, 0);
+            for (size_t row : dirty->rows) {
+                const size_t last = std::min(chunkCount, ((row + 1) * elementSize + kChunkBytes - 1) / kChunkBytes);
+                for (size_t k = row * elementSize / kChunkBytes; k < last; ++k) touched[k] = 1;
+            }
+        }
+        out.bytes = n;
+        out.chunks.clear();
+        out.chunks.reserve(chunkCount);
+        for (size_t off = 0, k = 0; off < n; off += kChunkBytes, ++k) {
+            const size_t len = std::min(kChunkBytes, n - off);
+            if (prev && k < prev->chunks.size()) {
+                const StateChunk& old = *prev->chunks[k];
+                if (old.bytes.size() == len && ((trusted && !touched[k]) || std::memcmp(old.bytes.data(), p + off, len) == 0)) {
+                    out.chunks.push_back(prev->chunks[k]);
+                    continue;
+                }
+            }
+            auto c = std::make_shared<StateChunk>();
+            c->bytes.assign(p + off, p + off + len);
+            out.chunks.push_back(std::move(c));
+        }
+    }
+
+    // `current` decrit le contenu actuel de dst : les blocs partages sont deja en place.
+    static void decode(const StateSegment& s, const StateSegment* current, void* dst, size_t capacityBytes) {
+        unsigned char* p = static_cast<unsigned char*>(dst);
+        size_t off = 0;
+        for (size_t k = 0; k < s.chunks.size(); ++k) {
+            const StateChunk& c = *s.chunks[k];
+            const bool same = current && k < current->chunks.size() && current->chunks[k] == s.chunks[k];
+            if (!same && off + c.bytes.size() <= capacityBytes) std::memcpy(p + off, c.bytes.data(), c.bytes.size());
+            off += c.bytes.size();
+        }
+    }
+
+    template <class T>
+    static void encodeVector(const std::vector<T>& v, const StateSegment* prev, StateSegment& out,
+                             const DirtyRows* dirty = nullptr) {
+        encode(v.data(), v.size() * sizeof(T), sizeof(T), prev, dirty, out);
+    }
+
+    static void encodeState(const ResourceManager& rm, BuildingManager& bm, const UpgradeManager& um,
+                            const StateSnapshot* prev, StateSnapshot& out) {
+        std::vector<double> res;
+        res.reserve(rm.size() * 2);
+        for (int r = 0; r < rm.size(); ++r) {
+            res.push_back(rm.at(r).qty);
+            res.push_back(rm.at(r).qmax);
+        }
+        encodeVector(res, prev ? &prev->resources : nullptr, out.resources);
+
+        std::vector<int> counts;
+        for (const auto& b : bm.prototypes) counts.push_back(b.count);
+        encodeVector(counts, prev ? &prev->counts : nullptr, out.counts);
+
+        std::vector<char> bought;
+        for (const auto& u : um.upgrades) bought.push_back(u.bought ? 1 : 0);
+        encodeVector(bought, prev ? &prev->upgrades : nullptr, out.upgrades);
+
+        const World& w = bm.instances;
+        // Record::archetype est copie tel quel : valide car les archetypes ne sont jamais detruits (World::archetypeFor).
+        encodeVector(w.records, prev ? &prev->records : nullptr, out.records, &w.recordsDirty);
+        encodeVector(w.freeList, prev ? &prev->freeList : nullptr, out.freeList, &w.freeListDirty);
+        out.liveCount = w.liveCount;
+        for (const auto& a : w.archetypes) {
+            ArchetypeImage img;
+            img.mask = a->mask;
+            const ArchetypeImage* old = prev ? prev->findArchetype(a->mask) : nullptr;
+            encodeVector(a->entities, old ? &old->entities : nullptr, img.entities, &a->dirty);
+            img.columns.resize(a->columns.size());
+            for (size_t k = 0; k < a->columns.size(); ++k) {
+                ColumnBase& col = *a->columns[k];
+                encode(col.raw(), col.size() * col.elementSize(), col.elementSize(),
+                       old && k < old->columns.size() ? &old->columns[k] : nullptr, &a->dirty, img.columns[k]);
+            }
+            out.archetypes.push_back(std::move(img));
+        }
+    }
+
+    template <class T>
+    static bool restoreVector(std::vector<T>& v, const StateSegment& target, const StateSegment& current) {
+        if (target.chunks == current.chunks) return false;
+        v.resize(target.bytes / sizeof(T));
+        decode(target, &current, v.data(), v.size() * sizeof(T));
+        return true;
+    }
+
+    // Lignes couvertes par les blocs qui different entre deux images d'un segment.
+    static void changedRows(const StateSegment& a, const StateSegment& b, size_t elementSize,
+                            std::vector<std::pair<size_t, size_t>>& out) {
+        const size_t n = std::max(a.chunks.size(), b.chunks.size());
+        for (size_t k = 0; k < n; ++k) {
+            if (k < a.chunks.size() && k < b.chunks.size() && a.chunks[k] == b.chunks[k]) continue;
+            out.push_back({ k * kChunkBytes / elementSize, ((k + 1) * kChunkBytes + elementSize - 1) / elementSize });
+        }
+    }
+
+    // Recopie les blocs d'instances qui different, puis replace dans la grille
+    // de voisinage les seules lignes concernees : les composants Adjacency,
+    // compteurs compris, reviennent avec l'instantane.
+    static void restoreWorld(BuildingManager& bm, const StateSnapshot& target, const StateSnapshot& current) {
+        World& w = bm.instances;
+        restoreVector(w.records, target.records, current.records);
+        restoreVector(w.freeList, target.freeList, current.freeList);
+        w.liveCount = target.liveCount;
+        static const StateSegment empty;
+        const int placed = componentId<BuildingInstance>();
+        std::vector<std::pair<size_t, size_t>> rows;
+        std::vector<std::pair<Entity, BuildingInstance>> moved;
+        for (auto& a : w.archetypes) {
+            const ArchetypeImage* img = target.findArchetype(a->mask);
+            const ArchetypeImage* cur = current.findArchetype(a->mask);
+            const StateSegment& te = img ? img->entities : empty;
+            const StateSegment& ce = cur ? cur->entities : empty;
+
+            // Instances a retirer de la grille : lignes des blocs qui vont changer.
+            rows.clear();
+            int placedColumn = -1;
+            for (size_t k = 0; k < a->ids.size(); ++k) {
+                if (a->ids[k] == placed) placedColumn = static_cast<int>(k);
+            }
+            if (placedColumn >= 0) {
+                const size_t k = static_cast<size_t>(placedColumn);
+                changedRows(te, ce, sizeof(Entity), rows);
+                changedRows(img && k < img->columns.size() ? img->columns[k] : empty,
+                            cur && k < cur->columns.size() ? cur->columns[k] : empty, sizeof(BuildingInstance), rows);
+                forRows(*a, rows, [&](Entity e, const BuildingInstance& inst) { bm.adjacency.unindex(e, inst); });
+            }
+
+            restoreVector(a->entities, te, ce);
+            for (size_t k = 0; k < a->columns.size(); ++k) {
+                const StateSegment& t = img && k < img->columns.size() ? img->columns[k] : empty;
+                const StateSegment& c = cur && k < cur->columns.size() ? cur->columns[k] : empty;
+                if (t.chunks == c.chunks) continue;
+                ColumnBase& col = *a->columns[k];
+                col.resize(t.bytes / col.elementSize());
+                decode(t, &c, col.raw(), col.size() * col.elementSize());
+            }
+
+            if (placedColumn >= 0) {
+                forRows(*a, rows, [&](Entity e, const BuildingInstance& inst) { moved.push_back({ e, inst }); });
+            }
+        }
+        // Toutes les sorties avant les entrees : une instance peut changer d'archetype.
+        for (const auto& [e, inst] : moved) bm.adjacency.index(e, inst);
+    }
+
+    // f(Entity, BuildingInstance) une fois par ligne existante des intervalles `rows`.
+    template <class F>
+    static void forRows(const Archetype& a, std::vector<std::pair<size_t, size_t>>& rows, F&& f) {
+        std::sort(rows.begin(), rows.end());
+        const BuildingInstance* inst = a.column<BuildingInstance>();
+        size_t next = 0;
+        for (const auto& [lo, hi] : rows) {
+            for (size_t r = std::max(lo, next); r < std::min(hi, a.size()); ++r) f(a.entities[r], inst[r]);
+            next = std::max(next, hi);
+        }
+    }
+};
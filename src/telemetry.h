@@ -0,0 +1,144 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "resource_manager.h"
+
+struct TelemetryBucket {
+    float qmin = 0.0f;
+    float qmax = 0.0f;
+    float qmean = 0.0f;
+    float rate = 0.0f;
+};
+
+// Historique borne des ressources : un anneau par palier (ticks, secondes,
+// minutes, heures). Chaque palier agrege `factor` seaux du palier inferieur
+// en min/max/moyenne, la memoire reste donc fixe quelle que soit la duree.
+class Telemetry {
+public:
+    Telemetry(int resources, double dt) : resourceCount(resources), tickDt(dt) {
+        const int ticksPerSecond = std::max(1, static_cast<int>(std::lround(1.0 / dt)));
+        addTier("ticks", 1, 600);
+        addTier("secondes", ticksPerSecond, 300);
+        addTier("minutes", 60, 240);
+        addTier("heures", 60, 720);
+        scratch.resize(resourceCount);
+        tickStart.assign(resourceCount, 0.0);
+    }
+
+    // A appeler juste avant la production du tick : le taux enregistre ne
+    // couvre que la production et les regles, pas les achats ni les
+    // restaurations faits entre deux ticks.
+    void beginTick(const ResourceManager& rm) {
+        const int n = std::min(resourceCount, rm.size());
+        for (int r = 0; r < n; ++r) tickStart[r] = rm.at(r).qty;
+        ticking = true;
+    }
+
+    void record(const ResourceManager& rm) {
+        const int n = std::min(resourceCount, rm.size());
+        for (int r = 0; r < n; ++r) {
+            const double q = rm.at(r).qty;
+            TelemetryBucket& b = scratch[r];
+            b.qmin = b.qmax = b.qmean = static_cast<float>(q);
+            b.rate = ticking ? static_cast<float>((q - tickStart[r]) / tickDt) : 0.0f;
+        }
+        ticking = false;
+        push(0, scratch);
+    }
+
+    // Oublie tout l'historique, par exemple apres un rembobinage : les seaux
+    // de la chronologie abandonnee ne doivent pas se meler a la nouvelle.
+    void clear() {
+        for (auto& t : tiers) {
+            t.head = 0;
+            t.filled = 0;
+            t.pendingCount = 0;
+        }
+        ticking = false;
+    }
+
+    int tierCount() const { return static_cast<int>(tiers.size()); }
+    const std::string& tierLabel(int t) const { return tiers[t].label; }
+    double tierPeriod(int t) const { return tiers[t].period; }
+    size_t size(int t) const { return tiers[t].filled; }
+    size_t capacity(int t) const { return tiers[t].capacity; }
+
+    // i = 0 pour le seau le plus ancien encore conserve.
+    const TelemetryBucket& at(int t, int res, size_t i) const {
+        const Tier& tier = tiers[t];
+        size_t slot = (tier.head + tier.capacity - tier.filled + i) % tier.capacity;
+        return tier.ring[static_cast<size_t>(res) * tier.capacity + slot];
+    }
+
+    void history(int t, int res, std::vector<TelemetryBucket>& out) const {
+        out.clear();
+        if (res < 0 || res >= resourceCount) return;
+        for (size_t i = 0; i < size(t); ++i) out.push_back(at(t, res, i));
+    }
+
+private:
+    struct Tier {
+        std::string label;
+        int factor;
+        double period;
+        size_t capacity;
+        size_t head = 0;
+        size_t filled = 0;
+        std::vector<TelemetryBucket> ring;
+        std::vector<TelemetryBucket> pending;
+        int pendingCount = 0;
+    };
+
+    int resourceCount;
+    double tickDt;
+    bool ticking = false;
+    std::vector<Tier> tiers;
+    std::vector<TelemetryBucket> scratch;
+    std::vector<double> tickStart;
+
+    void addTier(const char* label, int factor, size_t capacity) {
+        Tier t;
+        t.label = label;
+        t.factor = factor;
+        t.period = tiers.empty() ? tickDt : tiers.back().period * factor;
+        t.capacity = capacity;
+        t.ring.resize(static_cast<size_t>(resourceCount) * capacity);
+        t.pending.resize(resourceCount);
+        tiers.push_back(std::move(t));
+    }
+
+    void push(int t, const std::vector<TelemetryBucket>& buckets) {
+        Tier& tier = tiers[t];
+        for (int r = 0; r < resourceCount; ++r) {
+            tier.ring[static_cast<size_t>(r) * tier.capacity + tier.head] = buckets[r];
+        }
+        tier.head = (tier.head + 1) % tier.capacity;
+        if (tier.filled < tier.capacity) ++tier.filled;
+
+        if (t + 1 >= tierCount()) return;
+        Tier& up = tiers[t + 1];
+        for (int r = 0; r < resourceCount; ++r) {
+            TelemetryBucket& acc = up.pending[r];
+            const TelemetryBucket& b = buckets[r];
+            if (up.pendingCount == 0) {
+                acc = b;
+            } else {
+                acc.qmin = std::min(acc.qmin, b.qmin);
+                acc.qmax = std::max(acc.qmax, b.qmax);
+                acc.qmean += b.qmean;
+                acc.rate += b.rate;
+            }
+        }
+        if (++up.pendingCount < up.factor) return;
+
+        const float inv = 1.0f / static_cast<float>(up.factor);
+        for (auto& acc : up.pending) {
+            acc.qmean *= inv;
+            acc.rate *= inv;
+        }
+        up.pendingCount = 0;
+        push(t + 1, up.pending);
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool a vol de travail : une file par thread, le proprietaire depile par
+// l'arriere (LIFO), les autres volent par l'avant.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        for (unsigned i = 0; i < threads; ++i) workers.emplace_back([this, i] { workerLoop(static_cast<int>(i)); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return queues.size(); }
+
+    void submit(std::function<void()> task) {
+        size_t q = (currentPool() == this && currentWorker() >= 0)
+            ? static_cast<size_t>(currentWorker())
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            std::lock_guard<std::mutex> lk(queues[q]->m);
+            queues[q]->tasks.push_back(std::move(task));
+        }
+        pending.fetch_add(1, std::memory_order_release);
+        wake.notify_one();
+    }
+
+    // Decoupe [0, n) en blocs, puis aide a les executer jusqu'a la fin.
+    template <class F>
+    void parallelFor(size_t n, F&& body, size_t grain = 0) {
+        if (n == 0) return;
+        if (grain == 0) grain = std::max<size_t>(1, n / (size() * 8));
+        std::atomic<size_t> remaining{ (n + grain - 1) / grain };
+        for (size_t begin = 0; begin < n; begin += grain) {
+            size_t end = std::min(n, begin + grain);
+            submit([&body, &remaining, begin, end] {
+                for (size_t i = begin; i < end; ++i) body(i);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        const int self = currentPool() == this ? currentWorker() : -1;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            std::function<void()> task;
+            if (take(self, task)) task();
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    static int& currentWorker() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    bool take(int self, std::function<void()>& out) {
+        if (pending.load(std::memory_order_acquire) == 0) return false;
+        const size_t n = queues.size();
+        if (self >= 0) {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lk(own.m);
+            if (!own.tasks.empty()) {
+                out = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        const size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+        for (size_t i = 0; i < n; ++i) {
+            Queue& victim = *queues[(start + i) % n];
+            std::lock_guard<std::mutex> lk(victim.m);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int index) {
+        currentWorker() = index;
+        currentPool() = this;
+        for (;;) {
+            std::function<void()> task;
+            if (take(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(sleepMutex);
+            if (stopping && pending.load(std::memory_order_acquire) == 0) return;
+            wake.wait_for(lk, std::chrono::milliseconds(2), [this] {
+                return stopping || pending.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "building.h"
+#include "modifiers.h"
+#include "resource_manager.h"
+
+struct Upgrade {
+    std::string id, name;
+    std::vector<Cost> cost;
+    std::vector<Modifier> modifiers;
+    bool bought = false;
+};
+
+class UpgradeManager {
+public:
+    std::vector<Upgrade> upgrades;
+    ModifierSet modifiers;
+
+    void addUpgrade(const Upgrade& u) { upgrades.push_back(u); }
+
+    bool canBuy(int index, const ResourceManager& rm) const {
+        if (index < 0 || index >= (int)upgrades.size()) return false;
+        const Upgrade& u = upgrades[index];
+        return !u.bought && rm.canAfford(u.cost);
+    }
+
+    bool tryBuy(int index, ResourceManager& rm) {
+        if (!canBuy(index, rm)) return false;
+        Upgrade& u = upgrades[index];
+        rm.pay(u.cost);
+        for (auto m : u.modifiers) {
+            m.source = u.id;
+            modifiers.add(m);
+        }
+        u.bought = true;
+        return true;
+    }
+
+    // Signale les modificateurs qui ne touchent aucun batiment : une faute de
+    // frappe dans upgrades.json donnerait une amelioration achetable sans effet.
+    void checkModifiers(const std::vector<Building>& buildings) const {
+        for (const auto& u : upgrades) {
+            for (const auto& m : u.modifiers) {
+                bool known = m.building.empty();
+                bool used = false;
+                for (const auto& b : buildings) {
+                    if (!m.building.empty() && m.building != b.id) continue;
+                    known = true;
+                    used = used || touches(m, b);
+                }
+                const char* target = m.target == ModTarget::Cost ? "cout" : m.target == ModTarget::Input ? "entree" : "sortie";
+                if (!known) {
+                    std::printf("Avertissement: amelioration %s: modificateur sans effet (batiment inconnu: %s)\n", u.id.c_str(), m.building.c_str());
+                } else if (!used && m.building.empty()) {
+                    std::printf("Avertissement: amelioration %s: modificateur sans effet (aucun batiment n'a %s en %s)\n", u.id.c_str(), m.res.c_str(), target);
+                } else if (!used) {
+                    std::printf("Avertissement: amelioration %s: modificateur sans effet (%s n'a pas %s en %s)\n", u.id.c_str(), m.building.c_str(), m.res.c_str(), target);
+                }
+            }
+        }
+    }
+
+    // Annule un achat : retire ses modificateurs et rend son cout, hors plafond qmax.
+    bool refund(int index, ResourceManager& rm) {
+        if (index < 0 || index >= (int)upgrades.size() || !upgrades[index].bought) return false;
+        Upgrade& u = upgrades[index];
+        modifiers.removeSource(u.id);
+        for (const auto& c : u.cost) rm.get(c.res).qty += c.qty;
+        u.bought = false;
+        return true;
+    }
+
+private:
+    static bool touches(const Modifier& m, const Building& b) {
+        const std::vector<Cost>& slots = m.target == ModTarget::Cost ? b.base_cost : m.target == ModTarget::Input ? b.inputs : b.outputs;
+        for (const auto& c : slots) {
+            if (m.res.empty() || c.res == m.res) return true;
+        }
+        return false;
+    }
+};
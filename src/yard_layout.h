@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Geometrie de la fenetre du jeu. Partagee avec les outils hors-jeu : la
+// position des instances dans le chantier fixe leurs bonus de voisinage.
+namespace screen {
+constexpr int windowWidth = 1280;
+constexpr int windowHeight = 720;
+constexpr int layoutMargin = 20;
+constexpr int topMargin = 30;
+constexpr int bottomPanelHeight = 110;
+constexpr int resourcePanelWidth = 360;
+constexpr int buildingPanelWidth = 360;
+constexpr int mainAreaHeight = windowHeight - bottomPanelHeight - topMargin - layoutMargin;
+}
+
+struct YardPoint {
+    int x, y;
+};
+
+// Chantier : une ancre par type de batiment, rangees en colonnes, puis les
+// instances de ce type en grille a partir de l'ancre.
+class YardLayout {
+public:
+    static constexpr int slotSize = 64;
+    static constexpr int slotSpacing = 24;
+    static constexpr int labelHeight = 36;
+    static constexpr int instancePerRow = 2;
+    static constexpr int instanceSpacingX = 74;
+    static constexpr int instanceSpacingY = 74;
+
+    int x = 0, y = 0, w = 0, h = 0;
+    int rows = 1, columns = 1;
+
+    explicit YardLayout(size_t prototypes = 0) {
+        using namespace screen;
+        const int buildingPanelRight = 2 * layoutMargin + resourcePanelWidth + buildingPanelWidth;
+        x = buildingPanelRight + layoutMargin;
+        y = topMargin;
+        w = std::max(220, windowWidth - (buildingPanelRight + 2 * layoutMargin));
+        h = mainAreaHeight;
+
+        const int count = static_cast<int>(prototypes);
+        rows = std::max(1, (h - labelHeight) / (slotSize + slotSpacing));
+        columns = std::max(1, (count + rows - 1) / rows);
+        const int maxColumns = std::max(1, (w - 60) / (slotSize + slotSpacing));
+        if (columns > maxColumns) {
+            columns = maxColumns;
+            rows = std::max(1, (count + columns - 1) / columns);
+        }
+    }
+
+    YardPoint anchor(int index) const {
+        if (w <= 0) return YardPoint{ x, y + labelHeight };
+        int column = std::min(index / rows, columns - 1);
+        int row = std::min(index % rows, rows - 1);
+        return YardPoint{ x + 24 + column * (slotSize + slotSpacing), y + labelHeight + row * (slotSize + slotSpacing) };
+    }
+
+    // Position de la `built`-ieme instance du type `index`.
+    YardPoint instance(int index, int built) const {
+        const YardPoint a = anchor(index);
+        return YardPoint{ a.x + (built % instancePerRow) * instanceSpacingX, a.y + (built / instancePerRow) * instanceSpacingY };
+    }
+
+    // fn(i) pour chaque instance i < built du type `index` a distance^2 <= radius2
+    // de `p`. Les instances d'un type sont en lignes regulieres : seules les
+    // lignes qui croisent le rayon sont visitees.
+    template <class Fn>
+    void forEachNear(int index, int built, YardPoint p, double radius2, Fn&& fn) const {
+        if (built <= 0) return;
+        const YardPoint a = anchor(index);
+        const double radius = std::sqrt(radius2);
+        const int lastRow = (built - 1) / instancePerRow;
+        const int from = std::max(0, static_cast<int>(std::floor((p.y - radius - a.y) / instanceSpacingY)));
+        const int to = std::min(lastRow, static_cast<int>(std::ceil((p.y + radius - a.y) / instanceSpacingY)));
+        for (int row = from; row <= to; ++row) {
+            for (int c = 0; c < instancePerRow; ++c) {
+                const int i = row * instancePerRow + c;
+                if (i >= built) return;
+                const double dx = p.x - (a.x + c * instanceSpacingX), dy = p.y - (a.y + row * instanceSpacingY);
+                if (dx * dx + dy * dy <= radius2) fn(i);
+            }
+        }
+    }
+};
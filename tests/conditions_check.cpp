@@ -0,0 +1,144 @@
+// Verification hors-jeu de ConditionEngine : valeurs aleatoires (sauts,
+// valeurs egales aux seuils, variables inchangees), puis comparaison des
+// evenements de sync() avec une reevaluation complete de chaque condition.
+// Verifie aussi que QuestManager ne termine une quete que sur un etat reel.
+// Usage: conditions_check [--vars N] [--conditions N] [--steps N] [--seed S]
+// Code de sortie non nul au premier ecart.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/quest_manager.h"
+
+static int failures = 0;
+
+static void fail(const char* what, int step) {
+    std::printf("ECHEC etape %d: %s\n", step, what);
+    ++failures;
+}
+
+static bool holds(const std::vector<ConditionAtom>& atoms, const std::vector<double>& values) {
+    for (const auto& a : atoms) {
+        if (!a.test(values[a.var])) return false;
+    }
+    return true;
+}
+
+static void randomRun(int varCount, int conditionCount, int steps, unsigned seed) {
+    std::mt19937 rng(seed);
+    // Peu de seuils distincts : beaucoup d'egalites et de seuils partages.
+    auto level = [&]() { return static_cast<double>(rng() % 8) * 5.0; };
+
+    ConditionEngine engine;
+    std::vector<std::vector<ConditionAtom>> conditions;
+    for (int c = 0; c < conditionCount; ++c) {
+        std::vector<ConditionAtom> atoms;
+        const int n = 1 + static_cast<int>(rng() % 3);
+        for (int i = 0; i < n; ++i) {
+            atoms.push_back({ static_cast<int>(rng() % varCount), static_cast<CmpOp>(rng() % 4), level() });
+        }
+        engine.addCondition("c" + std::to_string(c), atoms);
+        conditions.push_back(atoms);
+    }
+
+    std::vector<double> values(static_cast<size_t>(varCount), 0.0);
+    std::vector<char> was(conditions.size(), 0);
+    std::vector<ConditionEvent> events;
+    for (int step = 0; step <= steps && failures == 0; ++step) {
+        if (step > 0) {
+            for (auto& v : values) {
+                const unsigned op = rng() % 4;
+                if (op == 0) v = level();
+                else if (op == 1) v += static_cast<double>(rng() % 3) - 1.0;
+            }
+        }
+        events.clear();
+        engine.sync([&](int var) { return values[var]; }, events);
+
+        std::vector<char> toggled(conditions.size(), 0);
+        for (const auto& e : events) {
+            if (toggled[e.condition]) fail("deux evenements pour une meme condition", step);
+            toggled[e.condition] = 1;
+            if (e.satisfied != holds(conditions[e.condition], values)) fail("evenement contraire a l'etat", step);
+        }
+        for (size_t c = 0; c < conditions.size(); ++c) {
+            const bool is = holds(conditions[c], values);
+            if (engine.satisfied(static_cast<int>(c)) != is) fail("etat de condition faux", step);
+            if ((is != (was[c] != 0)) != (toggled[c] != 0)) fail("basculement manque ou en trop", step);
+            was[c] = is ? 1 : 0;
+        }
+    }
+}
+
+// Deux variables franchissent leur seuil dans le meme tick : la quete ne
+// doit pas etre terminee sur un melange d'anciennes et de nouvelles valeurs.
+static void questCheck() {
+    ResourceManager rm;
+    rm.ensureResource("wood");
+    rm.ensureResource("stone");
+    std::vector<Building> buildings{ Building("farm", "farm", {}, {}) };
+    QuestManager qm;
+    qm.addQuest(Quest{ "q", "q", { { "wood", "", CmpOp::Ge, 10.0 }, { "stone", "", CmpOp::Lt, 5.0 } }, false });
+    qm.addQuest(Quest{ "farms", "farms", { { "", "farm", CmpOp::Ge, 2.0 } }, false });
+    qm.addQuest(Quest{ "bad", "bad", { { "gold", "", CmpOp::Ge, 1.0 } }, false });
+    qm.compile(rm, buildings);
+    if (qm.quests.size() != 2) fail("quete a condition inconnue conservee", 0);
+
+    if (qm.update(rm, buildings) != 0) fail("quete terminee au demarrage", 0);
+    rm.add("wood", 10.0);
+    rm.add("stone", 10.0);
+    if (qm.update(rm, buildings) != 0) fail("quete terminee sur un etat transitoire", 1);
+    rm.at(rm.indexOf("stone")).qty = 0.0;
+    buildings[0].count = 2;
+    if (qm.update(rm, buildings) != 2 || qm.completedNow.size() != 2) fail("quetes non terminees", 2);
+    if (qm.update(rm, buildings) != 0) fail("quete terminee deux fois", 3);
+}
+
+// Cout de sync() quand une seule variable change, sur un grand reseau.
+static void bench(int varCount, int conditionCount, unsigned seed) {
+    std::mt19937 rng(seed);
+    ConditionEngine engine;
+    for (int c = 0; c < conditionCount; ++c) {
+        engine.addCondition("c", { { static_cast<int>(rng() % varCount), CmpOp::Ge, static_cast<double>(rng() % 1000) } });
+    }
+    std::vector<double> values(static_cast<size_t>(varCount), 0.0);
+    std::vector<ConditionEvent> events;
+    engine.sync([&](int var) { return values[var]; }, events);
+
+    const int ticks = 10000;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        values[static_cast<size_t>(t) % values.size()] += 1.0;
+        events.clear();
+        engine.sync([&](int var) { return values[var]; }, events);
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%d variables, %d conditions : sync %.2f us par tick\n", varCount, conditionCount, us / ticks);
+}
+
+int main(int argc, char* argv[]) {
+    int vars = 6;
+    int conditions = 200;
+    int steps = 20000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--vars") == 0 && i + 1 < argc) vars = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--conditions") == 0 && i + 1 < argc) conditions = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) steps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    }
+    if (vars < 1 || conditions < 1) {
+        std::printf("Usage: conditions_check [--vars N] [--conditions N] [--steps N] [--seed S]\n");
+        return 1;
+    }
+
+    randomRun(vars, conditions, steps, seed);
+    if (failures == 0) questCheck();
+    if (failures == 0) bench(64, 100000, seed);
+    if (failures > 0) return 1;
+    std::printf("OK\n");
+    return 0;
+}
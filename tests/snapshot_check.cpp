@@ -0,0 +1,244 @@
+// Verification hors-jeu de StateHistory : captures, mutations du World
+// (construction, demolition, ajout et retrait de composants), restauration,
+// puis comparaison avec l'etat capture et recomptage du voisinage.
+// Usage: snapshot_check [--instances N] [--steps N] [--bench N] [--seed S]
+// Code de sortie non nul au premier ecart.
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../src/snapshot.h"
+
+struct Row {
+    BuildingInstance inst;
+    float efficiency;
+    int level;
+    float damage;
+    bool hasAdjacency;
+    float bonus;
+
+    bool operator==(const Row& o) const {
+        return std::tie(inst.type, inst.x, inst.y, efficiency, level, damage, hasAdjacency, bonus) ==
+               std::tie(o.inst.type, o.inst.x, o.inst.y, o.efficiency, o.level, o.damage, o.hasAdjacency, o.bonus);
+    }
+};
+
+struct Expected {
+    std::map<std::pair<uint32_t, uint32_t>, Row> rows;
+    std::vector<int> counts;
+    double wood = 0.0;
+    bool bought = false;
+};
+
+static int failures = 0;
+
+static void fail(const char* what, int step) {
+    std::printf("ECHEC etape %d: %s\n", step, what);
+    ++failures;
+}
+
+static Expected observe(const ResourceManager& rm, const BuildingManager& bm, const UpgradeManager& um) {
+    Expected out;
+    const World& w = bm.instances;
+    w.each<BuildingInstance>([&](Entity e, const BuildingInstance& inst) {
+        const Level* level = w.get<Level>(e);
+        const Damage* damage = w.get<Damage>(e);
+        const Adjacency* adj = w.get<Adjacency>(e);
+        out.rows[{ e.index, e.generation }] = Row{ inst, w.get<Efficiency>(e)->value, level ? level->value : -1,
+                                                   damage ? damage->value : -1.0f, adj != nullptr, adj ? adj->bonus : 0.0f };
+    });
+    for (const auto& b : bm.prototypes) out.counts.push_back(b.count);
+    out.wood = rm.at(0).qty;
+    out.bought = um.upgrades[0].bought;
+    return out;
+}
+
+// Chaque entite vivante est retrouvee par get() a sa propre ligne, et size() les compte toutes.
+static void checkWorld(const World& w, int step) {
+    size_t seen = 0;
+    for (const Archetype& arch : w.allArchetypes()) {
+        const BuildingInstance* col = arch.column<BuildingInstance>();
+        for (size_t r = 0; r < arch.size(); ++r) {
+            const Entity e = arch.entities[r];
+            if (!w.alive(e)) fail("entite morte dans un archetype", step);
+            else if (col && w.get<BuildingInstance>(e) != col + r) fail("enregistrement desynchronise", step);
+            ++seen;
+        }
+        for (const auto& c : arch.columns) {
+            if (c->size() != arch.size()) fail("colonne de taille incoherente", step);
+        }
+    }
+    if (seen != w.size()) fail("nombre d'entites vivantes incoherent", step);
+}
+
+// Bonus attendu pour chaque cible, par force brute sur toutes les instances.
+static void checkAdjacency(const BuildingManager& bm, int step) {
+    const World& w = bm.instances;
+    std::vector<std::pair<Entity, BuildingInstance>> all;
+    w.each<BuildingInstance>([&](Entity e, const BuildingInstance& inst) { all.push_back({ e, inst }); });
+    for (const auto& [e, inst] : all) {
+        double expected = 0.0;
+        for (const auto& t : bm.adjacency.terms()) {
+            if (t.target != inst.type) continue;
+            int near = 0;
+            for (const auto& [o, other] : all) {
+                const double dx = inst.x - other.x, dy = inst.y - other.y;
+                if (o != e && other.type == t.source && dx * dx + dy * dy <= t.radius2) ++near;
+            }
+            expected += t.bonusFor(near);
+        }
+        const Adjacency* adj = w.get<Adjacency>(e);
+        if (std::fabs((adj ? adj->bonus : 0.0) - expected) > 1e-4) {
+            fail("bonus de voisinage different du recomptage", step);
+            return;
+        }
+    }
+}
+
+static Entity build(BuildingManager& bm, int type, int x, int y) {
+    ++bm.prototypes[type].count;
+    const Entity e = bm.instances.create(BuildingInstance{ type, x, y }, Efficiency{});
+    bm.adjacency.place(bm.instances, e);
+    return e;
+}
+
+static void setup(BuildingManager& bm) {
+    for (const char* id : { "farm", "nursery", "mine" }) bm.addPrototype(Building(id, id, {}, { { "wood", 1.0 } }));
+    bm.adjacency.addRule({ "farm_nursery", "farm", "nursery", 120.0, 0.1, 0.5 });
+    bm.adjacency.addRule({ "farm_farm", "farm", "farm", 60.0, 0.05, 0.0 });
+    bm.adjacency.addRule({ "mine_farm", "mine", "farm", 150.0, 0.02, 0.1 });
+    bm.adjacency.compile(bm.prototypes);
+}
+
+// Mutations et restaurations aleatoires sur un petit monde dense, verifie a chaque etape.
+static void randomRun(int instances, int steps, unsigned seed) {
+    ResourceManager rm;
+    rm.ensureResource("wood").qty = 100.0;
+    BuildingManager bm;
+    setup(bm);
+    UpgradeManager um;
+    um.addUpgrade(Upgrade{ "tools", "Outils", {}, { Modifier{ "", "farm", "food", ModTarget::Output, 0.0, 1.5 } }, false });
+
+    std::mt19937 rng(seed);
+    // Coordonnees negatives comprises : cellules de grille d'indice negatif.
+    auto coord = [&]() { return static_cast<int>(rng() % 1200) - 200; };
+    std::vector<Entity> live;
+    for (int i = 0; i < instances; ++i) live.push_back(build(bm, static_cast<int>(rng() % 3), coord(), coord()));
+
+    StateHistory history(64);
+    std::vector<Expected> expected;
+    auto capture = [&](double t) {
+        history.capture(rm, bm, um, t, "auto");
+        expected.push_back(observe(rm, bm, um));
+        if (expected.size() > history.size()) expected.erase(expected.begin());
+    };
+    capture(0.0);
+
+    for (int step = 1; step <= steps && failures == 0; ++step) {
+        const unsigned op = rng() % 10;
+        if (op < 3 || live.empty()) {
+            live.push_back(build(bm, static_cast<int>(rng() % 3), coord(), coord()));
+        } else if (op < 5) {
+            const size_t i = rng() % live.size();
+            bm.demolish(live[i]);
+            live[i] = live.back();
+            live.pop_back();
+        } else if (op == 5) {
+            bm.instances.add(live[rng() % live.size()], Level{ static_cast<int>(rng() % 5) + 1 });
+        } else if (op == 6) {
+            bm.instances.add(live[rng() % live.size()], Damage{ 0.25f });
+        } else if (op == 7) {
+            bm.instances.remove<Damage>(live[rng() % live.size()]);
+        } else if (op == 8) {
+            if (Efficiency* eff = bm.instances.get<Efficiency>(live[rng() % live.size()])) {
+                eff->value = static_cast<float>(rng() % 100) / 100.0f;
+            }
+            rm.at(0).qty += 1.0;
+            um.tryBuy(0, rm);
+        } else if (rng() % 3 == 0 && history.size() > 1) {
+            const size_t target = rng() % history.size();
+            history.restore(target, rm, bm, um);
+            expected.resize(target + 1);
+            const Expected now = observe(rm, bm, um);
+            if (!(now.rows == expected.back().rows)) fail("instances differentes de l'instantane", step);
+            if (now.counts != expected.back().counts) fail("effectifs differents de l'instantane", step);
+            if (now.wood != expected.back().wood || now.bought != expected.back().bought) {
+                fail("ressources ou ameliorations differentes de l'instantane", step);
+            }
+            live.clear();
+            const World& w = bm.instances;
+            w.each<BuildingInstance>([&](Entity e, const BuildingInstance&) { live.push_back(e); });
+        } else {
+            capture(static_cast<double>(step));
+            // Ecriture sur place, sans changement de taille, puis retour immediat.
+            const Entity e = live[rng() % live.size()];
+            if (Level* level = bm.instances.get<Level>(e)) level->value += 1;
+            else bm.instances.get<Efficiency>(e)->value += 1.0f;
+            if (rng() % 2 == 0) {
+                history.restore(history.size() - 1, rm, bm, um);
+                if (!(observe(rm, bm, um).rows == expected.back().rows)) fail("ecriture sur place non annulee", step);
+            }
+        }
+        checkWorld(bm.instances, step);
+        checkAdjacency(bm, step);
+    }
+}
+
+// Capture puis restauration avec un seul bloc modifie, sur un grand monde.
+static void bench(int instances, unsigned seed) {
+    ResourceManager rm;
+    rm.ensureResource("wood").qty = 100.0;
+    BuildingManager bm;
+    setup(bm);
+    UpgradeManager um;
+    std::mt19937 rng(seed);
+    Entity probe{};
+    for (int i = 0; i < instances; ++i) {
+        probe = build(bm, static_cast<int>(rng() % 3), static_cast<int>(rng() % 20000), static_cast<int>(rng() % 20000));
+    }
+    StateHistory history(8);
+    history.capture(rm, bm, um, 0.0, "auto");
+
+    using clock = std::chrono::steady_clock;
+    bm.instances.get<Efficiency>(probe)->value = 0.75f;
+    const auto t0 = clock::now();
+    history.capture(rm, bm, um, 1.0, "auto");
+    const auto t1 = clock::now();
+    bm.instances.get<Efficiency>(probe)->value = 0.25f;
+    const auto t2 = clock::now();
+    history.restore(history.size() - 1, rm, bm, um);
+    const auto t3 = clock::now();
+    if (bm.instances.get<Efficiency>(probe)->value != 0.75f) fail("restauration du bloc modifie", 0);
+    checkWorld(bm.instances, 0);
+
+    std::printf("%d instances : capture %.3f ms, restauration %.3f ms (un bloc modifie), %.1f Mo\n", instances,
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t3 - t2).count(),
+                static_cast<double>(history.uniqueBytes()) / (1024.0 * 1024.0));
+}
+
+int main(int argc, char* argv[]) {
+    int instances = 500;
+    int steps = 3000;
+    int benchInstances = 100000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--instances") == 0 && i + 1 < argc) instances = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) steps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) benchInstances = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = static_cast<unsigned>(std::atoi(argv[++i]));
+    }
+
+    randomRun(instances, steps, seed);
+    if (failures == 0 && benchInstances > 0) bench(benchInstances, seed);
+    if (failures > 0) return 1;
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,339 @@
+// Balayage d'equilibrage Monte Carlo sur les donnees du jeu.
+// Usage: balance_sweep [--data DIR] [--out FILE] [--threads N] sweep.json
+//
+// Chaque variante modifie les batiments selon "params" (grille "values" ou
+// intervalle "min"/"max" tire au hasard), puis joue "runs" parties avec des
+// politiques de joueur scriptees. Sortie CSV : distribution du temps
+// d'atteinte de chaque jalon par variante.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../src/data_loader.h"
+#include "../src/simulation.h"
+#include "../src/thread_pool.h"
+
+using json = nlohmann::json;
+
+enum class ParamField { Growth, Cost, Input, Output };
+
+struct SweepParam {
+    std::string label;
+    int building = -1;
+    int res = -1;
+    ParamField field = ParamField::Growth;
+    std::vector<double> values;
+    double min = 0.0, max = 0.0;
+};
+
+struct Milestone {
+    std::string id;
+    int building = -1;
+    int count = 1;
+    int res = -1;
+    double qty = 0.0;
+
+    bool reached(const EconomyState& s) const {
+        if (building >= 0) return s.counts[building] >= count;
+        return s.values[res] >= qty;
+    }
+};
+
+enum class Policy { Cheapest, Random, Balanced };
+
+struct SweepConfig {
+    size_t variants = 100;
+    int runs = 100;
+    double duration = 3600.0;
+    double step = 1.0;
+    uint64_t seed = 1;
+    std::vector<SweepParam> params;
+    std::vector<Milestone> milestones;
+};
+
+struct MilestoneStats {
+    int reached = 0;
+    double mean = 0.0, p10 = 0.0, p50 = 0.0, p90 = 0.0;
+};
+
+struct VariantResult {
+    std::vector<double> params;
+    std::vector<MilestoneStats> stats;
+};
+
+static bool parse_config(const json& j, const EconomyModel& model, SweepConfig& cfg) {
+    cfg.variants = j.value("variants", cfg.variants);
+    cfg.runs = j.value("runs", cfg.runs);
+    cfg.duration = j.value("duration", cfg.duration);
+    cfg.step = j.value("step", cfg.step);
+    cfg.seed = j.value("seed", cfg.seed);
+    if (!(cfg.step > 0.0)) {
+        std::printf("Pas de simulation invalide: %g (doit etre > 0)\n", cfg.step);
+        return false;
+    }
+
+    size_t gridSize = 1;
+    bool allGrid = true;
+    if (j.contains("params")) {
+        for (auto& p : j["params"]) {
+            SweepParam sp;
+            const std::string building = p.value("building", "");
+            const std::string field = p.value("field", "growth");
+            const std::string res = p.value("res", "");
+            sp.building = model.buildingIndex(building);
+            if (sp.building < 0) {
+                std::printf("Batiment inconnu: %s\n", building.c_str());
+                return false;
+            }
+            if (field == "cost") sp.field = ParamField::Cost;
+            else if (field == "input") sp.field = ParamField::Input;
+            else if (field == "output") sp.field = ParamField::Output;
+            if (sp.field != ParamField::Growth) {
+                sp.res = model.resourceIndex(res);
+                if (sp.res < 0) {
+                    std::printf("Ressource inconnue: %s\n", res.c_str());
+                    return false;
+                }
+            }
+            sp.label = building + "." + field + (res.empty() ? "" : "." + res);
+            if (p.contains("values")) {
+                for (auto& v : p["values"]) sp.values.push_back(v.get<double>());
+                gridSize *= std::max<size_t>(1, sp.values.size());
+            } else {
+                allGrid = false;
+                sp.min = p.value("min", 0.0);
+                sp.max = p.value("max", sp.min);
+            }
+            cfg.params.push_back(sp);
+        }
+    }
+    if (allGrid && !cfg.params.empty() && !j.contains("variants")) cfg.variants = gridSize;
+
+    if (j.contains("milestones")) {
+        for (auto& m : j["milestones"]) {
+            Milestone ms;
+            ms.id = m.value("id", "");
+            if (m.contains("building")) {
+                ms.building = model.buildingIndex(m.value("building", ""));
+                ms.count = m.value("count", 1);
+            } else {
+                ms.res = model.resourceIndex(m.value("res", ""));
+                ms.qty = m.value("qty", 0.0);
+            }
+            if (ms.building < 0 && ms.res < 0) {
+                std::printf("Jalon invalide: %s\n", ms.id.c_str());
+                return false;
+            }
+            cfg.milestones.push_back(ms);
+        }
+    }
+    return !cfg.milestones.empty();
+}
+
+static void set_param(EconomyModel& m, const SweepParam& p, double v) {
+    BuildingKernel& k = m.buildings[p.building];
+    auto setTerm = [&](std::vector<RuleTerm>& terms) {
+        for (auto& t : terms) {
+            if (t.res == p.res) t.qty = v;
+        }
+    };
+    switch (p.field) {
+        case ParamField::Growth: k.growth = v; break;
+        case ParamField::Cost: setTerm(k.cost); break;
+        case ParamField::Input: setTerm(k.production.inputs); break;
+        case ParamField::Output: setTerm(k.production.outputs); break;
+    }
+}
+
+static double next_cost_total(const EconomyModel& m, const EconomyState& s, int b) {
+    const BuildingKernel& k = m.buildings[b];
+    double total = 0.0;
+    for (const auto& c : k.cost) total += c.qty;
+    return total * std::pow(k.growth, s.counts[b]);
+}
+
+static int pick_building(const EconomyModel& m, const EconomyState& s, Policy policy, std::mt19937_64& rng) {
+    int chosen = -1;
+    double best = std::numeric_limits<double>::infinity();
+    int affordable = 0;
+    for (int b = 0; b < static_cast<int>(m.buildings.size()); ++b) {
+        if (!m.canAfford(s, b)) continue;
+        ++affordable;
+        double key = 0.0;
+        switch (policy) {
+            case Policy::Cheapest: key = next_cost_total(m, s, b); break;
+            case Policy::Balanced: key = static_cast<double>(s.counts[b]); break;
+            case Policy::Random:
+                // Tirage uniforme parmi les batiments abordables (reservoir).
+                if (std::uniform_int_distribution<int>(1, affordable)(rng) == 1) chosen = b;
+                continue;
+        }
+        if (key < best) {
+            best = key;
+            chosen = b;
+        }
+    }
+    return chosen;
+}
+
+// Une variante peut rendre un batiment gratuit : sans plafond, une seule
+// decision l'acheterait indefiniment.
+static constexpr int kMaxBuysPerDecision = 64;
+
+static double quantile(std::vector<double>& v, double q) {
+    size_t i = static_cast<size_t>(q * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<long>(i), v.end());
+    return v[i];
+}
+
+static void run_variant(const EconomyModel& base, const EconomyState& start, const SweepConfig& cfg,
+                        size_t variant, VariantResult& out) {
+    std::mt19937_64 rng(cfg.seed * 0x9E3779B97F4A7C15ull + variant);
+    EconomyModel model = base;
+
+    size_t radix = variant;
+    for (const auto& p : cfg.params) {
+        double v;
+        if (!p.values.empty()) {
+            v = p.values[radix % p.values.size()];
+            radix /= p.values.size();
+        } else {
+            v = std::uniform_real_distribution<double>(p.min, p.max)(rng);
+        }
+        set_param(model, p, v);
+        out.params.push_back(v);
+    }
+
+    const size_t milestoneCount = cfg.milestones.size();
+    std::vector<std::vector<double>> times(milestoneCount);
+    std::vector<double> hit(milestoneCount);
+
+    for (int run = 0; run < cfg.runs; ++run) {
+        const Policy policy = static_cast<Policy>(run % 3);
+        const double thinkTime = std::uniform_real_distribution<double>(cfg.step, std::max(cfg.step, 30.0))(rng);
+        EconomyState s = start;
+        std::fill(hit.begin(), hit.end(), -1.0);
+        size_t remaining = milestoneCount;
+        double nextDecision = 0.0;
+
+        while (s.time < cfg.duration && remaining > 0) {
+            if (s.time >= nextDecision) {
+                int b;
+                for (int n = 0; n < kMaxBuysPerDecision && (b = pick_building(model, s, policy, rng)) >= 0; ++n) {
+                    model.buy(s, b);
+                }
+                nextDecision = s.time + thinkTime;
+            }
+            model.step(s, cfg.step);
+            for (size_t m = 0; m < milestoneCount; ++m) {
+                if (hit[m] < 0.0 && cfg.milestones[m].reached(s)) {
+                    hit[m] = s.time;
+                    --remaining;
+                }
+            }
+        }
+        for (size_t m = 0; m < milestoneCount; ++m) {
+            if (hit[m] >= 0.0) times[m].push_back(hit[m]);
+        }
+    }
+
+    out.stats.resize(milestoneCount);
+    for (size_t m = 0; m < milestoneCount; ++m) {
+        auto& t = times[m];
+        MilestoneStats& st = out.stats[m];
+        st.reached = static_cast<int>(t.size());
+        if (t.empty()) continue;
+        double sum = 0.0;
+        for (double x : t) sum += x;
+        st.mean = sum / static_cast<double>(t.size());
+        st.p10 = quantile(t, 0.1);
+        st.p50 = quantile(t, 0.5);
+        st.p90 = quantile(t, 0.9);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::filesystem::path dataDir = "data";
+    std::string outPath, configPath;
+    unsigned threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strcmp(a, "--data") == 0 && i + 1 < argc) dataDir = argv[++i];
+        else if (std::strcmp(a, "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (std::strcmp(a, "--threads") == 0 && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else configPath = a;
+    }
+    if (configPath.empty()) {
+        std::printf("Usage: balance_sweep [--data DIR] [--out FILE] [--threads N] sweep.json\n");
+        return 1;
+    }
+
+    ResourceManager rm;
+    std::vector<Building> buildings;
+    RuleSet rules;
+    UpgradeManager um;
+    loadGameData(dataDir, rm, buildings, rules, um);
+    um.modifiers.refresh(buildings);
+    AdjacencyIndex adjacency;
+    loadAdjacency(adjacency, (dataDir / "adjacency.json").string());
+    adjacency.compile(buildings);
+    EconomyModel model(rm, buildings, rules);
+    model.adjacency = adjacency.terms();
+    const EconomyState start = model.capture(rm, buildings);
+
+    json jc;
+    std::ifstream cf(configPath);
+    if (!cf.is_open()) {
+        std::printf("Erreur: impossible d'ouvrir %s\n", configPath.c_str());
+        return 1;
+    }
+    try {
+        cf >> jc;
+    } catch (const std::exception& ex) {
+        std::printf("Erreur: lecture JSON %s (%s)\n", configPath.c_str(), ex.what());
+        return 1;
+    }
+    SweepConfig cfg;
+    if (!parse_config(jc, model, cfg)) return 1;
+
+    std::vector<VariantResult> results(cfg.variants);
+    ThreadPool pool(threads);
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(cfg.variants, [&](size_t v) { run_variant(model, start, cfg, v, results[v]); });
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    FILE* out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::printf("Erreur: impossible d'ecrire %s\n", outPath.c_str());
+        return 1;
+    }
+    std::fprintf(out, "variant");
+    for (const auto& p : cfg.params) std::fprintf(out, ",%s", p.label.c_str());
+    std::fprintf(out, ",milestone,runs,reached,mean,p10,p50,p90\n");
+    for (size_t v = 0; v < results.size(); ++v) {
+        const VariantResult& r = results[v];
+        for (size_t m = 0; m < cfg.milestones.size(); ++m) {
+            const MilestoneStats& st = r.stats[m];
+            std::fprintf(out, "%zu", v);
+            for (double x : r.params) std::fprintf(out, ",%g", x);
+            std::fprintf(out, ",%s,%d,%d", cfg.milestones[m].id.c_str(), cfg.runs, st.reached);
+            if (st.reached > 0) std::fprintf(out, ",%.1f,%.1f,%.1f,%.1f\n", st.mean, st.p10, st.p50, st.p90);
+            else std::fprintf(out, ",,,,\n");
+        }
+    }
+    if (out != stdout) std::fclose(out);
+
+    std::fprintf(stderr, "%zu variantes x %d parties en %.1f s (%zu threads)\n",
+                 cfg.variants, cfg.runs, secs, pool.size());
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Planificateur d'ordre de construction hors-jeu.
+// Usage: planner [--data DIR] [--beam N] [--depth N] [--step S] res=qty [res=qty ...]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "../src/data_loader.h"
+#include "../src/planner.h"
+
+int main(int argc, char* argv[]) {
+    std::filesystem::path dataDir = "data";
+    PlannerOptions opts;
+    std::vector<std::pair<std::string, double>> targets;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strcmp(a, "--data") == 0 && i + 1 < argc) dataDir = argv[++i];
+        else if (std::strcmp(a, "--beam") == 0 && i + 1 < argc) opts.beamWidth = std::atoi(argv[++i]);
+        else if (std::strcmp(a, "--depth") == 0 && i + 1 < argc) opts.maxDepth = std::atoi(argv[++i]);
+        else if (std::strcmp(a, "--step") == 0 && i + 1 < argc) opts.step = std::atof(argv[++i]);
+        else if (const char* eq = std::strchr(a, '=')) targets.push_back({ std::string(a, eq), std::atof(eq + 1) });
+        else {
+            std::printf("Argument inconnu: %s\n", a);
+            return 1;
+        }
+    }
+    if (targets.empty()) {
+        std::printf("Usage: planner [--data DIR] [--beam N] [--depth N] [--step S] res=qty [res=qty ...]\n");
+        return 1;
+    }
+
+    ResourceManager rm;
+    std::vector<Building> buildings;
+    RuleSet rules;
+    UpgradeManager um;
+    loadGameData(dataDir, rm, buildings, rules, um);
+    um.modifiers.refresh(buildings);
+    AdjacencyIndex adjacency;
+    loadAdjacency(adjacency, (dataDir / "adjacency.json").string());
+    adjacency.compile(buildings);
+
+    EconomyModel model(rm, buildings, rules);
+    model.adjacency = adjacency.terms();
+    PlanGoal goal;
+    for (const auto& [res, qty] : targets) {
+        int r = model.resourceIndex(res);
+        if (r < 0) {
+            std::printf("Ressource inconnue: %s\n", res.c_str());
+            return 1;
+        }
+        goal.targets.push_back({ r, qty });
+    }
+
+    ThreadPool pool;
+    BuildOrderPlanner planner(model, pool, opts);
+    auto t0 = std::chrono::steady_clock::now();
+    Plan plan = planner.plan(model.capture(rm, buildings), goal);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!plan.reached) {
+        std::printf("Objectif hors d'atteinte (%.0f ms, %zu threads)\n", ms, pool.size());
+        return 2;
+    }
+    std::printf("Objectif atteint en %.1f s (%.0f ms, %zu threads)\n", plan.finishTime, ms, pool.size());
+    for (size_t i = 0; i < plan.steps.size(); ++i) {
+        const Building& b = buildings[plan.steps[i].building];
+        std::printf("  %2zu. t=%7.1f s  %s\n", i + 1, plan.steps[i].time, b.name.c_str());
+    }
+    return 0;
+}